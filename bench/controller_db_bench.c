@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL2/SDL.h"
+
+#include "controller_db.h"
+
+#define BENCH_RUNS 20
+
+typedef enum BenchMode_s {
+    BENCH_MODE_Text,//what startup used to do, SDL parses the whole text db
+    BENCH_MODE_BinaryAll,//bulk load of the baked table
+    BENCH_MODE_BinaryDevice,//what startup does now, load the table and register one device
+    BENCH_MODE_Count,
+} BenchMode;
+
+static const char* const mode_names[BENCH_MODE_Count] = { "text parse", "binary, every mapping", "binary, one device" };
+
+static double ticks_to_ms(Uint64 ticks) {
+    return (double)ticks * 1e3 / (double)SDL_GetPerformanceFrequency();
+}
+
+//each run gets a fresh controller subsystem so no run pays for or profits from the mappings of the previous one
+static Uint64 bench_run(BenchMode mode, const char* text_path, const char* binary_path, int* added) {
+    if(SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) != 0) {
+        fprintf(stderr, "SDL_InitSubSystem: %s\n", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if(mode == BENCH_MODE_Text) {
+        *added = SDL_GameControllerAddMappingsFromFile(text_path);
+    }
+    else {
+        ControllerDb db;
+        controller_db_load(&db, SDL_RWFromFile(binary_path, "rb"));
+        if(mode == BENCH_MODE_BinaryAll) {
+            *added = controller_db_add_all(&db);
+        }
+        else {
+            //a device from the middle of the table that this platform knows
+            Uint32 device = db.entry_count / 2;
+            while(device + 1 < db.entry_count && SDL_SwapLE32(db.entries[device].platform) != db.platform) {
+                device++;
+            }
+            SDL_JoystickGUID guid;
+            SDL_memcpy(guid.data, db.entries[device].guid, sizeof(guid.data));
+            const char* mapping = controller_db_find(&db, guid);
+            *added = controller_db_add_defaults(&db) + (mapping && SDL_GameControllerAddMapping(mapping) >= 0);
+        }
+        controller_db_free(&db);
+    }
+    Uint64 end = SDL_GetPerformanceCounter();
+
+    SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+    return end - start;
+}
+
+//a device that only differs from a db entry in its crc and version has to get that entry, like from SDL's own lookup
+static bool check_loose_guid(const ControllerDb* db) {
+    for(Uint32 i = 0; i < db->entry_count; i++) {
+        SDL_JoystickGUID guid;
+        SDL_memcpy(guid.data, db->entries[i].guid, sizeof(guid.data));
+        Uint8* data = guid.data;
+        bool has_ids = (data[4] || data[5]) && (data[8] || data[9]) && !(data[6] || data[7] || data[10] || data[11]);
+        if(!has_ids || data[2] || data[3] || data[12] || data[13]) {
+            continue;
+        }
+        const char* mapping = controller_db_find(db, guid);
+        if(!mapping) {
+            continue;//another platform's
+        }
+
+        data[2] = 0x34;//crc
+        data[3] = 0x12;
+        data[12] = 0x10;//version
+        data[13] = 0x01;
+        return controller_db_find(db, guid) == mapping;
+    }
+    return false;//nothing to check with
+}
+
+//controller_db_bench [gamecontrollerdb.txt] [gamecontrollerdb.bin], startup cost of registering controller mappings
+int main(int argc, char* argv[]) {
+    const char* text_path = argc > 1 ? argv[1] : "assets/gamecontrollerdb.txt";
+    const char* binary_path = argc > 2 ? argv[2] : "assets/gamecontrollerdb.bin";
+
+    ControllerDb db;
+    if(!controller_db_load(&db, SDL_RWFromFile(binary_path, "rb")) || db.entry_count == 0) {
+        fprintf(stderr, "%s: %s\n", binary_path, SDL_GetError());
+        return EXIT_FAILURE;
+    }
+    if(!check_loose_guid(&db)) {
+        fprintf(stderr, "%s: a device with another crc and version got no mapping\n", binary_path);
+        return EXIT_FAILURE;
+    }
+    controller_db_free(&db);
+
+    printf("%d runs on %s\n", BENCH_RUNS, SDL_GetPlatform());
+    for(int mode = 0; mode < BENCH_MODE_Count; mode++) {
+        Uint64 total = 0;
+        Uint64 best = (Uint64)-1;
+        int added = 0;
+        for(int i = 0; i < BENCH_RUNS; i++) {
+            Uint64 ticks = bench_run((BenchMode)mode, text_path, binary_path, &added);
+            total += ticks;
+            best = ticks < best ? ticks : best;
+        }
+        if(added < 0) {
+            fprintf(stderr, "%s: %s\n", mode_names[mode], SDL_GetError());
+            return EXIT_FAILURE;
+        }
+        printf("%-24s %8.3f ms avg %8.3f ms best, %d mappings\n", mode_names[mode], ticks_to_ms(total) / BENCH_RUNS, ticks_to_ms(best), added);
+    }
+
+    SDL_Quit();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL2/SDL.h"
+
+#include "hf_intersection.h"
+#include "hf_batch.h"
+#include "rng.h"
+#include "vine.h"
+#include "world.h"
+
+#include "../hf/bench/hf_bench_shapes.h"
+
+#define BENCH_REPEATS 5//the median and the best of these are reported
+#define BENCH_SEED 23//the same shapes and worlds on every run and platform
+#define BENCH_TARGET_W 960//same size as the game world
+#define BENCH_TARGET_H 540
+
+#ifdef HF_INLINE
+#define BENCH_HF_MODE "inline"
+#else
+#define BENCH_HF_MODE "library"
+#endif
+
+typedef struct Bench_s {
+    const char* name;
+    int iterations;//per repeat
+    int param;
+    void (*setup)(int param);//not timed, may be NULL
+    float (*run)(int iterations, int param);//returns something that depends on every call, so none are optimized away
+} Bench;
+
+static Rng rng;
+static float sink;
+
+static HF_Line lines[BENCH_SHAPES];
+static HF_Triangle triangles[BENCH_SHAPES];
+static HF_Circle circles[BENCH_SHAPES];
+static HF_Vec2f points[BENCH_SHAPES];
+static float angles[BENCH_SHAPES];
+
+static Vine vine;
+static VineRender vine_render;
+static World world;
+
+//no window and no video driver, the software renderer draws into a surface, so it runs on a box without a display
+static SDL_Surface* surface;
+static SDL_Renderer* renderer;
+static SDL_Texture* tex_plants;
+static SDL_Texture* tex_ground;
+static SDL_Texture* tex_sky;
+
+static float random_float(float max) {
+    return rng_float(&rng) * max;
+}
+
+//the same kind of shapes hf_bench times, plus the angles the vector benches take
+static void setup_shapes(void) {
+    bench_setup_shapes(random_float, lines, triangles, circles, points);
+    for(int i = 0; i < BENCH_SHAPES; i++) {
+        angles[i] = random_float(2.f * (float)M_PI);
+    }
+}
+
+//one run function per expression
+#define BENCH_EXPRESSION(function_name, expression) \
+    static float function_name(int iterations, int param) { \
+        (void)param; \
+        float sum = 0.f; \
+        BENCH_PAIRS(sum, iterations, expression) \
+        return sum; \
+    }
+
+BENCH_EXPRESSION(run_intersection_lines, lines_hit(lines[index], lines[next]))
+BENCH_EXPRESSION(run_intersection_triangles, triangles_hit(triangles[index], triangles[next]))
+BENCH_EXPRESSION(run_intersection_circles, circles_hit(circles[index], circles[next]))
+BENCH_EXPRESSION(run_intersection_line_triangle, line_triangle_hit(lines[index], triangles[next]))
+BENCH_EXPRESSION(run_intersection_line_circle, line_circle_hit(lines[index], circles[next]))
+BENCH_EXPRESSION(run_intersection_triangle_circle, triangle_circle_hit(triangles[index], circles[next]))
+BENCH_EXPRESSION(run_line_closest_point, hf_line_closest_point(lines[index], points[next]).x)
+
+BENCH_EXPRESSION(run_vec2f_add, hf_vec2f_add(points[index], points[next]).x)
+BENCH_EXPRESSION(run_vec2f_subtract, hf_vec2f_subtract(points[index], points[next]).x)
+BENCH_EXPRESSION(run_vec2f_multiply, hf_vec2f_multiply(points[index], angles[next]).x)
+BENCH_EXPRESSION(run_vec2f_divide, hf_vec2f_divide(points[index], angles[next] + 1.f).x)
+BENCH_EXPRESSION(run_vec2f_rotate, hf_vec2f_rotate(points[index], angles[next]).x)
+BENCH_EXPRESSION(run_vec2f_rotate_cached, hf_vec2f_rotate_cached(points[index], angles[next], angles[index]).x)
+BENCH_EXPRESSION(run_vec2f_lerp, hf_vec2f_lerp(points[index], points[next], .25f).x)
+BENCH_EXPRESSION(run_vec2f_normalize, hf_vec2f_normalize(points[index]).x)
+BENCH_EXPRESSION(run_vec2f_magnitude, hf_vec2f_magnitude(points[index]))
+BENCH_EXPRESSION(run_vec2f_sqr_magnitude, hf_vec2f_sqr_magnitude(points[index]))
+BENCH_EXPRESSION(run_vec2f_dot, hf_vec2f_dot(points[index], points[next]))
+BENCH_EXPRESSION(run_vec2f_angle, hf_vec2f_angle(points[index]))
+
+BENCH_EXPRESSION(run_world_point_is_in_bubble, world_point_is_in_bubble(&world, points[index]))
+
+//an outward spiral, its curvature only decreases so it never crosses itself
+static void vine_spiral(HF_Vec2f center, int point_count) {
+    vine_reset(&vine, center, 0.f);
+    point_count = SDL_min(point_count, VINE_MAX_POINTS);
+    for(int i = 0; vine_point_count(&vine) < point_count; i++) {
+        vine.angle += .5f / (1.f + (float)i * .01f);
+        vine_expand(&vine);
+    }
+}
+
+static void setup_vine_full(int param) {
+    (void)param;
+    vine_spiral((HF_Vec2f) { 0.f, 0.f }, VINE_MAX_POINTS);
+}
+
+//at capacity every expand drops the oldest point as well
+static float run_vine_expand(int iterations, int param) {
+    (void)param;
+    for(int i = 0; i < iterations; i++) {
+        vine.angle += .01f;
+        vine_expand(&vine);
+    }
+    return vine.position.x;
+}
+
+static void setup_vine_points(int point_count) {
+    vine_spiral((HF_Vec2f) { 0.f, 0.f }, point_count);
+}
+
+static float run_vine_collision_self(int iterations, int param) {
+    (void)param;
+    int hits = 0;
+    for(int i = 0; i < iterations; i++) {
+        vine.collision.valid = false;//measure the query, not the cached result
+        hits += vine_collision_self(&vine, NULL);
+    }
+    return (float)hits;
+}
+
+static void setup_vine_draw(int param) {
+    (void)param;
+    vine_spiral((HF_Vec2f) { BENCH_TARGET_W / 2.f, BENCH_TARGET_H / 2.f }, VINE_MAX_POINTS);
+    vine_interpolate_tip(&vine, &vine_render, 1.f);//builds the mesh outside the timer
+    SDL_SetRenderTarget(renderer, NULL);
+}
+
+//the flush makes the renderer rasterize now instead of batching past the timer
+static float run_vine_draw(int iterations, int param) {
+    (void)param;
+    for(int i = 0; i < iterations; i++) {
+        vine_draw(&vine, &vine_render, renderer, tex_plants, 0, (HF_Vec2f) { 0.f, 0.f });
+        SDL_RenderFlush(renderer);
+    }
+    return (float)vine_point_count(&vine);
+}
+
+static float run_world_generate(int iterations, int param) {
+    (void)param;
+    for(int i = 0; i < iterations; i++) {
+        world_generate(&world, &rng);
+    }
+    return (float)world.bubble_count;
+}
+
+//a fresh world baked once, so only the composition itself is timed
+static void setup_world_compose(int param) {
+    (void)param;
+    world_generate(&world, &rng);
+    world_clear(&world, renderer);
+    world_compose_texture(&world, renderer);
+    SDL_RenderFlush(renderer);
+}
+
+//param is the side of the square redone each time, 0 for the whole world
+static float run_world_compose_texture(int iterations, int param) {
+    for(int i = 0; i < iterations; i++) {
+        SDL_Rect rect = { 0, 0, BENCH_TARGET_W, BENCH_TARGET_H };
+        if(param > 0) {
+            rect = (SDL_Rect) { (i * 97) % (BENCH_TARGET_W - param), (i * 53) % (BENCH_TARGET_H - param), param, param };
+        }
+        world_mark_dirty(&world, rect);
+        world_compose_texture(&world, renderer);
+        SDL_RenderFlush(renderer);
+    }
+    return (float)world.dirty_rect_count;
+}
+
+static void setup_world_points(int param) {
+    (void)param;
+    world_generate(&world, &rng);
+    for(int i = 0; i < BENCH_SHAPES; i++) {
+        points[i] = (HF_Vec2f) { random_float(BENCH_TARGET_W), random_float(BENCH_TARGET_H) };
+    }
+}
+
+static const Bench benches[] = {
+    { "hf_intersection_lines", 2000000, 0, NULL, run_intersection_lines },
+    { "hf_intersection_triangles", 500000, 0, NULL, run_intersection_triangles },
+    { "hf_intersection_circles", 2000000, 0, NULL, run_intersection_circles },
+    { "hf_intersection_line_triangle", 1000000, 0, NULL, run_intersection_line_triangle },
+    { "hf_intersection_line_circle", 2000000, 0, NULL, run_intersection_line_circle },
+    { "hf_intersection_triangle_circle", 1000000, 0, NULL, run_intersection_triangle_circle },
+    { "hf_line_closest_point", 2000000, 0, NULL, run_line_closest_point },
+    { "hf_vec2f_add", 4000000, 0, NULL, run_vec2f_add },
+    { "hf_vec2f_subtract", 4000000, 0, NULL, run_vec2f_subtract },
+    { "hf_vec2f_multiply", 4000000, 0, NULL, run_vec2f_multiply },
+    { "hf_vec2f_divide", 4000000, 0, NULL, run_vec2f_divide },
+    { "hf_vec2f_rotate", 2000000, 0, NULL, run_vec2f_rotate },
+    { "hf_vec2f_rotate_cached", 4000000, 0, NULL, run_vec2f_rotate_cached },
+    { "hf_vec2f_lerp", 4000000, 0, NULL, run_vec2f_lerp },
+    { "hf_vec2f_normalize", 4000000, 0, NULL, run_vec2f_normalize },
+    { "hf_vec2f_magnitude", 4000000, 0, NULL, run_vec2f_magnitude },
+    { "hf_vec2f_sqr_magnitude", 4000000, 0, NULL, run_vec2f_sqr_magnitude },
+    { "hf_vec2f_dot", 4000000, 0, NULL, run_vec2f_dot },
+    { "hf_vec2f_angle", 2000000, 0, NULL, run_vec2f_angle },
+
+    { "vine_expand/full", 200000, 0, setup_vine_full, run_vine_expand },
+    { "vine_collision_self/10", 200000, 10, setup_vine_points, run_vine_collision_self },
+    { "vine_collision_self/100", 100000, 100, setup_vine_points, run_vine_collision_self },
+    { "vine_collision_self/1000", 20000, 1000, setup_vine_points, run_vine_collision_self },
+    { "vine_draw/full", 100, 0, setup_vine_draw, run_vine_draw },
+
+    { "world_generate", 2000, 0, NULL, run_world_generate },
+    { "world_compose_texture/full", 50, 0, setup_world_compose, run_world_compose_texture },
+    { "world_compose_texture/64", 2000, 64, setup_world_compose, run_world_compose_texture },
+    { "world_point_is_in_bubble", 2000000, 0, setup_world_points, run_world_point_is_in_bubble },
+};
+
+//solid texture of w * h with a lighter border, enough for the blending and sampling to do their real work
+static SDL_Texture* create_texture(int w, int h, Uint32 color) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, w, h);
+    Uint32* pixels = SDL_malloc(sizeof(Uint32) * (size_t)w * (size_t)h);
+    if(!texture || !pixels) {
+        SDL_free(pixels);
+        return texture;
+    }
+    for(int y = 0; y < h; y++) {
+        for(int x = 0; x < w; x++) {
+            pixels[y * w + x] = x % 21 == 0 || y % 21 == 0 ? 0xFFFFFFFFu : color;
+        }
+    }
+    SDL_UpdateTexture(texture, NULL, pixels, w * (int)sizeof(Uint32));
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_free(pixels);
+    return texture;
+}
+
+static bool setup_renderer(void) {
+    surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_TARGET_W, BENCH_TARGET_H, 32, SDL_PIXELFORMAT_ARGB8888);
+    renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if(!renderer) {
+        return false;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    tex_plants = create_texture(6 * 21, 2 * 21, 0xC040A040u);//6 sprites of 21 pixels, the layout of the vine sheet
+    tex_ground = create_texture(32, 32, 0xFF806040u);
+    tex_sky = create_texture(32, 32, 0xFF4080C0u);
+    if(!tex_plants || !tex_ground || !tex_sky) {
+        return false;
+    }
+
+    world_init(&world, BENCH_TARGET_W, BENCH_TARGET_H);
+    world_init_render(&world, renderer);
+    world_set_tiles(&world, renderer, tex_ground, tex_sky);
+    world_generate(&world, &rng);
+    return true;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double value_a = *(const double*)a;
+    double value_b = *(const double*)b;
+    return value_a < value_b ? -1 : (value_a > value_b ? 1 : 0);
+}
+
+static void write_json_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for(const char* c = text; *c; c++) {
+        if(*c == '"' || *c == '\\') {
+            fprintf(file, "\\%c", *c);
+        }
+        else if((unsigned char)*c < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned int)(unsigned char)*c);
+        }
+        else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+//every workload BENCH_REPEATS times, progress on stderr and the results as JSON on stdout or --output
+int main(int argc, char* argv[]) {
+    const char* output_path = NULL;
+    const char* filter = NULL;//only the benches with it in their name
+    const char* label = "";//e.g. the commit, to tell runs apart when tracking regressions
+    bool scalar = false;//keeps the batch kernels on the fallback
+    for(int i = 1; i < argc; i++) {
+        if(SDL_strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--scalar") == 0) {
+            scalar = true;
+        }
+    }
+
+    const char* backend_names[] = HF_BATCH_BACKEND_NAMES;
+    hf_batch_select_best(!scalar && SDL_HasSSE2(), !scalar && SDL_HasAVX2(), !scalar && SDL_HasNEON());
+
+    rng_seed(&rng, BENCH_SEED);
+    if(!setup_renderer()) {
+        fprintf(stderr, "no software renderer: %s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+    SDL_RendererInfo renderer_info;
+    SDL_GetRendererInfo(renderer, &renderer_info);
+
+    FILE* output = output_path ? fopen(output_path, "w") : stdout;
+    if(!output) {
+        fprintf(stderr, "can't write %s\n", output_path);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output, "{\n  \"label\": ");
+    write_json_string(output, label);
+    fprintf(output, ",\n  \"platform\": ");
+    write_json_string(output, SDL_GetPlatform());
+    fprintf(output, ",\n  \"renderer\": ");
+    write_json_string(output, renderer_info.name);
+    fprintf(output, ",\n  \"batch_backend\": \"%s\",\n  \"hf_mode\": \"%s\",\n  \"vine_max_points\": %d,\n  \"repeats\": %d,\n  \"results\": [",
+        backend_names[hf_batch_backend()], BENCH_HF_MODE, VINE_MAX_POINTS, BENCH_REPEATS
+    );
+
+    int bench_count = 0;
+    for(size_t b = 0; b < SDL_arraysize(benches); b++) {
+        const Bench* bench = &benches[b];
+        if(filter && !SDL_strstr(bench->name, filter)) {
+            continue;
+        }
+
+        //every bench starts from the seed, so a --filter run gets the inputs it gets in a full run
+        rng_seed(&rng, BENCH_SEED);
+        setup_shapes();
+        if(bench->setup) {
+            bench->setup(bench->param);
+        }
+        sink += bench->run(bench->iterations / 10 + 1, bench->param);//warm up the caches and the lazily built tables
+
+        double ns_per_op[BENCH_REPEATS];
+        for(int r = 0; r < BENCH_REPEATS; r++) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            sink += bench->run(bench->iterations, bench->param);
+            Uint64 end = SDL_GetPerformanceCounter();
+            ns_per_op[r] = (double)(end - start) * 1e9 / (double)SDL_GetPerformanceFrequency() / (double)bench->iterations;
+        }
+        SDL_qsort(ns_per_op, BENCH_REPEATS, sizeof(double), compare_double);
+
+        fprintf(stderr, "%-34s %12.2f ns/op (best %.2f)\n", bench->name, ns_per_op[BENCH_REPEATS / 2], ns_per_op[0]);
+        fprintf(output, "%s\n    { \"name\": \"%s\", \"iterations\": %d, \"ns_per_op\": %.3f, \"ns_per_op_best\": %.3f }",
+            bench_count > 0 ? "," : "", bench->name, bench->iterations, ns_per_op[BENCH_REPEATS / 2], ns_per_op[0]
+        );
+        bench_count++;
+    }
+    fprintf(output, "\n  ]\n}\n");
+    fprintf(stderr, "(sink %g)\n", (double)sink);
+
+    bool ok = output == stdout ? fflush(output) == 0 : fclose(output) == 0;
+
+    world_deinit(&world);
+    SDL_DestroyTexture(tex_plants);
+    SDL_DestroyTexture(tex_ground);
+    SDL_DestroyTexture(tex_sky);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL2/SDL.h"
+
+#include "vine.h"
+#include "hf_intersection.h"
+#include "hf_batch.h"
+
+#define BENCH_STEPS 100000
+#define BENCH_QUERIES 10000
+
+//vine_bench_inline is built with HF_INLINE, the difference between the two is the cost of the hf_math calls
+#ifdef HF_INLINE
+#define BENCH_HF_MODE "hf_math inlined from the headers"
+#else
+#define BENCH_HF_MODE "hf_math library calls"
+#endif
+
+//copy of the old vine_expand, which shifted every point one index down once the vine was full
+typedef struct LegacyVine_s {
+    HF_Vec2f position;
+    float angle;
+    HF_Vec2f points[VINE_MAX_POINTS];
+    int point_count;
+} LegacyVine;
+
+static void legacy_vine_expand(LegacyVine* vine) {
+    HF_Vec2f vec = { VINE_EXPAND_DISTANCE, 0.f };
+    vec = hf_vec2f_rotate(vec, vine->angle);
+
+    if(vine->point_count == 0) {
+        vine->points[0] = vine->position;
+        vine->point_count++;
+    }
+
+    if(vine->point_count >= VINE_MAX_POINTS) {
+        for(int i = 1; i < VINE_MAX_POINTS; i++) {
+            vine->points[i - 1] = vine->points[i];
+        }
+    }
+    else {
+        vine->point_count++;
+    }
+
+    vine->points[vine->point_count - 1] = vine->position = hf_vec2f_add(vine->position, vec);
+}
+
+//copy of the old vine_collision_self, which tested the front line against every line of the vine
+static bool legacy_vine_collision_self(LegacyVine* vine, HF_Vec2f* hit_point) {
+    static HF_Line vine_lines[VINE_MAX_POINTS - 1];
+    for(int i = 1; i < vine->point_count; i++) {
+        vine_lines[i - 1] = (HF_Line) { vine->points[i - 1], vine->points[i] };
+    }
+
+    HF_Vec2f expand_dir = hf_vec2f_rotate((HF_Vec2f) { VINE_EXPAND_DISTANCE, 0.f }, vine->angle);
+    HF_Line front_line = { vine->position, hf_vec2f_add(vine->position, expand_dir) };
+
+    int line_count = vine->point_count - 1;
+    for(int i = 0; i < line_count - 1; i++) {
+        if(hf_intersection_lines(front_line, vine_lines[i], hit_point)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//an outward spiral, its curvature only decreases so it never crosses itself
+static float spiral_turn(int step) {
+    return .5f / (1.f + (float)step * .01f);
+}
+
+static double ticks_to_ns(Uint64 ticks, int steps) {
+    if(steps <= 0) {
+        return 0.0;
+    }
+    return (double)ticks * 1e9 / (double)SDL_GetPerformanceFrequency() / (double)steps;
+}
+
+//grows to BENCH_STEPS points, reporting the cost while filling up and once the vine is at capacity
+int main(int argc, char* argv[]) {
+    //--scalar keeps the batch kernels on the fallback, to compare against the widest ones the cpu has
+    bool scalar = argc > 1 && SDL_strcmp(argv[1], "--scalar") == 0;
+    const char* backend_names[] = HF_BATCH_BACKEND_NAMES;
+    hf_batch_select_best(!scalar && SDL_HasSSE2(), !scalar && SDL_HasAVX2(), !scalar && SDL_HasNEON());
+
+    static LegacyVine legacy_vine;
+    static Vine vine;
+
+    legacy_vine = (LegacyVine) { .position = { 0.f, 0.f }, .angle = 0.f };
+    Uint64 legacy_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < VINE_MAX_POINTS; i++) {
+        legacy_vine_expand(&legacy_vine);
+    }
+    Uint64 legacy_full = SDL_GetPerformanceCounter();
+    for(int i = VINE_MAX_POINTS; i < BENCH_STEPS; i++) {
+        legacy_vine.angle += .01f;
+        legacy_vine_expand(&legacy_vine);
+    }
+    Uint64 legacy_end = SDL_GetPerformanceCounter();
+
+    vine = (Vine) { .position = { 0.f, 0.f }, .angle = 0.f };
+    Uint64 ring_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < VINE_MAX_POINTS; i++) {
+        vine_expand(&vine);
+    }
+    Uint64 ring_full = SDL_GetPerformanceCounter();
+    for(int i = VINE_MAX_POINTS; i < BENCH_STEPS; i++) {
+        vine.angle += .01f;
+        vine_expand(&vine);
+    }
+    Uint64 ring_end = SDL_GetPerformanceCounter();
+
+    HF_Vec2f legacy_last = legacy_vine.points[legacy_vine.point_count - 1];
+    HF_Vec2f ring_last = vine.points[(vine.tail - 1) & VINE_POINT_MASK];
+    if(legacy_last.x != ring_last.x || legacy_last.y != ring_last.y) {
+        printf("vine_expand: implementations diverged\n");
+        return EXIT_FAILURE;
+    }
+
+    //collision of the front line against a full vine that doesn't cross itself
+    legacy_vine = (LegacyVine) { .position = { 0.f, 0.f }, .angle = 0.f };
+    vine_reset(&vine, (HF_Vec2f) { 0.f, 0.f }, 0.f);
+    for(int i = 0; i < VINE_MAX_POINTS; i++) {
+        legacy_vine.angle += spiral_turn(i);
+        legacy_vine_expand(&legacy_vine);
+        vine.angle += spiral_turn(i);
+        vine_expand(&vine);
+    }
+
+    int legacy_hits = 0;
+    Uint64 legacy_query_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < BENCH_QUERIES; i++) {
+        legacy_hits += legacy_vine_collision_self(&legacy_vine, NULL);
+    }
+    Uint64 legacy_query_end = SDL_GetPerformanceCounter();
+
+    int grid_hits = 0;
+    Uint64 grid_query_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < BENCH_QUERIES; i++) {
+        vine.collision.valid = false;//measure the query, not the cached result
+        grid_hits += vine_collision_self(&vine, NULL);
+    }
+    Uint64 grid_query_end = SDL_GetPerformanceCounter();
+
+    //turn back into the vine so both have to find an actual hit
+    legacy_vine.angle += (float)M_PI * .5f;
+    vine.angle += (float)M_PI * .5f;
+    for(int i = 0; i < 40; i++) {
+        legacy_vine_expand(&legacy_vine);
+        vine_expand(&vine);
+    }
+    HF_Vec2f legacy_hit = { 0.f, 0.f };
+    HF_Vec2f grid_hit = { 0.f, 0.f };
+    bool legacy_collided = legacy_vine_collision_self(&legacy_vine, &legacy_hit);
+    bool grid_collided = vine_collision_self(&vine, &grid_hit);
+
+    if(legacy_hits != grid_hits || legacy_collided != grid_collided || legacy_hit.x != grid_hit.x || legacy_hit.y != grid_hit.y) {
+        printf("vine_collision_self: implementations diverged\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("vine_expand, %d steps, VINE_MAX_POINTS %d\n", BENCH_STEPS, VINE_MAX_POINTS);
+    printf("%-8s %16s %16s %16s\n", "", "filling ns/op", "full ns/op", "total ns/op");
+    printf("%-8s %16.2f %16.2f %16.2f\n", "shift",
+        ticks_to_ns(legacy_full - legacy_start, VINE_MAX_POINTS),
+        ticks_to_ns(legacy_end - legacy_full, BENCH_STEPS - VINE_MAX_POINTS),
+        ticks_to_ns(legacy_end - legacy_start, BENCH_STEPS)
+    );
+    printf("%-8s %16.2f %16.2f %16.2f\n", "ring",
+        ticks_to_ns(ring_full - ring_start, VINE_MAX_POINTS),
+        ticks_to_ns(ring_end - ring_full, BENCH_STEPS - VINE_MAX_POINTS),
+        ticks_to_ns(ring_end - ring_start, BENCH_STEPS)
+    );
+
+
+    printf("\nvine_collision_self, %d points, %d queries, %s, %s batch kernels\n", VINE_MAX_POINTS, BENCH_QUERIES, BENCH_HF_MODE, backend_names[hf_batch_backend()]);
+    printf("%-8s %16.2f ns/op\n", "linear", ticks_to_ns(legacy_query_end - legacy_query_start, BENCH_QUERIES));
+    printf("%-8s %16.2f ns/op\n", "grid", ticks_to_ns(grid_query_end - grid_query_start, BENCH_QUERIES));
+
+    return EXIT_SUCCESS;
+}
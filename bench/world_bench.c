@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL2/SDL.h"
+
+#include "rng.h"
+#include "world.h"
+#include "hf_batch.h"
+
+#define BENCH_BUBBLES 10000
+#define BENCH_QUERIES 1000000
+#define BENCH_AREA 8192
+
+//the old world_point_is_in_bubble, a scan over every bubble
+static bool linear_point_is_in_bubble(const HF_Circle* bubbles, int bubble_count, HF_Vec2f point) {
+    for(int i = 0; i < bubble_count; i++) {
+        HF_Circle bubble = bubbles[i];
+        HF_Vec2f vec = hf_vec2f_subtract(bubble.position, point);
+        if(hf_vec2f_sqr_magnitude(vec) < bubble.radius * bubble.radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static Rng bench_rng;//seeded, the same bubbles and points on every platform
+
+static float random_float(float max) {
+    return rng_float(&bench_rng) * max;
+}
+
+static double ticks_to_ns(Uint64 ticks, int steps) {
+    if(steps <= 0) {
+        return 0.0;
+    }
+    return (double)ticks * 1e9 / (double)SDL_GetPerformanceFrequency() / (double)steps;
+}
+
+//point in bubble over BENCH_BUBBLES bubbles with the same size range the game uses
+int main(int argc, char* argv[]) {
+    //--scalar keeps the batch kernels on the fallback, to compare against the widest ones the cpu has
+    bool scalar = argc > 1 && SDL_strcmp(argv[1], "--scalar") == 0;
+    const char* backend_names[] = HF_BATCH_BACKEND_NAMES;
+    hf_batch_select_best(!scalar && SDL_HasSSE2(), !scalar && SDL_HasAVX2(), !scalar && SDL_HasNEON());
+
+    static HF_Circle bubbles[BENCH_BUBBLES];
+    static HF_Vec2f points[BENCH_QUERIES];
+    rng_seed(&bench_rng, 23);
+    for(int i = 0; i < BENCH_BUBBLES; i++) {
+        bubbles[i] = (HF_Circle) {
+            .position = { random_float(BENCH_AREA), random_float(BENCH_AREA) },
+            .radius = (float)WORLD_MIN_SIZE_HOLE + random_float(WORLD_MAX_SIZE_HOLE - WORLD_MIN_SIZE_HOLE),
+        };
+    }
+    for(int i = 0; i < BENCH_QUERIES; i++) {
+        points[i] = (HF_Vec2f) { random_float(BENCH_AREA), random_float(BENCH_AREA) };
+    }
+
+    WorldBubbleGrid grid = { 0 };
+    Uint64 build_start = SDL_GetPerformanceCounter();
+    world_bubble_grid_build(&grid, bubbles, BENCH_BUBBLES, WORLD_BUBBLE_GRID_CELL_SIZE);
+    Uint64 build_end = SDL_GetPerformanceCounter();
+
+    int cell_counts[3] = { 0, 0, 0 };
+    for(int i = 0; i < grid.columns * grid.rows; i++) {
+        cell_counts[grid.cells[i]]++;
+    }
+
+    //the linear scan is slow enough that a slice of the queries is plenty
+    int linear_queries = BENCH_QUERIES / 100;
+    int linear_hits = 0;
+    Uint64 linear_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < linear_queries; i++) {
+        linear_hits += linear_point_is_in_bubble(bubbles, BENCH_BUBBLES, points[i]);
+    }
+    Uint64 linear_end = SDL_GetPerformanceCounter();
+
+    int grid_hits = 0;
+    Uint64 grid_start = SDL_GetPerformanceCounter();
+    for(int i = 0; i < BENCH_QUERIES; i++) {
+        grid_hits += world_bubble_grid_contains(&grid, points[i]);
+    }
+    Uint64 grid_end = SDL_GetPerformanceCounter();
+
+    for(int i = 0; i < linear_queries; i++) {
+        if(linear_point_is_in_bubble(bubbles, BENCH_BUBBLES, points[i]) != world_bubble_grid_contains(&grid, points[i])) {
+            printf("world_point_is_in_bubble: implementations diverged at (%f, %f)\n", (double)points[i].x, (double)points[i].y);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("world_point_is_in_bubble, %d bubbles over %dx%d, %s batch kernels\n", BENCH_BUBBLES, BENCH_AREA, BENCH_AREA, backend_names[hf_batch_backend()]);
+    printf("grid: %dx%d cells of %.0f, %d empty, %d full, %d boundary, %d listed circles\n",
+        grid.columns, grid.rows, (double)grid.cell_size,
+        cell_counts[WORLD_BUBBLE_CELL_Empty], cell_counts[WORLD_BUBBLE_CELL_Full], cell_counts[WORLD_BUBBLE_CELL_Boundary],
+        grid.starts[grid.columns * grid.rows]
+    );
+    printf("build %.3f ms\n", ticks_to_ns(build_end - build_start, 1) / 1e6);
+    printf("%-8s %16.2f ns/op (%d queries, %.1f%% hits)\n", "linear",
+        ticks_to_ns(linear_end - linear_start, linear_queries), linear_queries, 100.0 * linear_hits / linear_queries);
+    printf("%-8s %16.2f ns/op (%d queries, %.1f%% hits)\n", "grid",
+        ticks_to_ns(grid_end - grid_start, BENCH_QUERIES), BENCH_QUERIES, 100.0 * grid_hits / BENCH_QUERIES);
+
+    world_bubble_grid_free(&grid);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/hf_intersection.h"
+#include "../include/hf_batch.h"
+#include "hf_bench_shapes.h"
+
+#define BENCH_CALLS 2000000
+
+//the rotate into a local frame versions hf_math had before, kept to compare speed and results
+static HF_Vec2f trig_line_closest_point(HF_Line line, HF_Vec2f point) {
+    HF_Vec2f line_vec = hf_vec2f_subtract(line.end, line.start);
+    float angle = hf_vec2f_angle(line_vec);
+
+    float rotation_sin = sinf(-angle);
+    float rotation_cos = cosf(-angle);
+    HF_Line line_rot = {
+        hf_vec2f_rotate_cached(line.start, rotation_sin, rotation_cos),
+        hf_vec2f_rotate_cached(line.end, rotation_sin, rotation_cos),
+    };
+    HF_Vec2f point_rot = hf_vec2f_rotate(point, -angle);
+
+    float line_max_x = line_rot.start.x > line_rot.end.x ? line_rot.start.x : line_rot.end.x;
+    float line_min_x = line_rot.start.x <= line_rot.end.x ? line_rot.start.x : line_rot.end.x;
+    HF_Vec2f aligned_point = {
+        point_rot.x > line_max_x ? line_max_x : (point_rot.x < line_min_x ? line_min_x : point_rot.x),
+        line_rot.start.y,
+    };
+    return hf_vec2f_rotate_cached(aligned_point, -rotation_sin, rotation_cos);
+}
+
+static bool trig_intersection_lines(HF_Line a, HF_Line b, HF_Vec2f* hit_point) {
+    HF_Vec2f a_vec = hf_vec2f_subtract(a.end, a.start);
+    HF_Vec2f a_vec90 = { a_vec.y, -a_vec.x };
+    if((hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.start, a.start)) > 0.f) == (hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.end, a.start)) > 0.f)) {
+        return false;
+    }
+    HF_Vec2f b_vec = hf_vec2f_subtract(b.end, b.start);
+    HF_Vec2f b_vec90 = { b_vec.y, -b_vec.x };
+    if((hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.start, b.start)) > 0.f) == (hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.end, b.start)) > 0.f)) {
+        return false;
+    }
+
+    if(hit_point) {
+        float angle = hf_vec2f_angle(a_vec);
+        float rotation_sin = sinf(-angle);
+        float rotation_cos = cosf(-angle);
+        HF_Vec2f as_rot = hf_vec2f_rotate_cached(a.start, rotation_sin, rotation_cos);
+        HF_Vec2f bs_rot = hf_vec2f_rotate_cached(b.start, rotation_sin, rotation_cos);
+        HF_Vec2f bv_rot = hf_vec2f_rotate_cached(b_vec, rotation_sin, rotation_cos);
+
+        float by_amp = fabsf(bv_rot.y);
+        float lerp = by_amp > 0.f ? fabsf(as_rot.y - bs_rot.y) / by_amp : 0.5f;
+        *hit_point = hf_vec2f_add(b.start, hf_vec2f_multiply(b_vec, lerp));
+    }
+    return true;
+}
+
+static float random_float(float max) {
+    return (float)rand() / (float)RAND_MAX * max;
+}
+
+static HF_Line lines[BENCH_SHAPES];
+static HF_Triangle triangles[BENCH_SHAPES];
+static HF_Circle circles[BENCH_SHAPES];
+static HF_Vec2f points[BENCH_SHAPES];
+
+static float sink;//results go here so the calls can't be optimized away
+
+static void bench_report(const char* name, clock_t ticks) {
+    double seconds = (double)ticks / CLOCKS_PER_SEC;
+    printf("%-34s %8.2f M calls/s %7.1f ns/call\n", name, seconds > 0.0 ? BENCH_CALLS / seconds / 1e6 : 0.0, seconds * 1e9 / BENCH_CALLS);
+}
+
+#define BENCH(name, expression) do { \
+    clock_t start = clock(); \
+    BENCH_PAIRS(sink, BENCH_CALLS, expression) \
+    bench_report(name, clock() - start); \
+} while(0)
+
+static float trig_lines_hit(HF_Line a, HF_Line b) {
+    HF_Vec2f hit;
+    return trig_intersection_lines(a, b, &hit) ? hit.x : 0.f;
+}
+
+//hf_bench has no SDL, so it asks the compiler which backends this cpu can run
+static bool batch_cpu_has(HF_BatchBackend backend) {
+    switch(backend) {
+    case HF_BATCH_BACKEND_Scalar:
+        return true;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    case HF_BATCH_BACKEND_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case HF_BATCH_BACKEND_AVX2:
+        return __builtin_cpu_supports("avx2");
+#elif defined(__aarch64__)
+    case HF_BATCH_BACKEND_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+static float batch_x[BENCH_SHAPES];
+static float batch_y[BENCH_SHAPES];
+static float batch_end_x[BENCH_SHAPES];
+static float batch_end_y[BENCH_SHAPES];
+static float batch_radius[BENCH_SHAPES];
+static float batch_out_x[BENCH_SHAPES];
+static float batch_out_y[BENCH_SHAPES];
+static int batch_hits[BENCH_SHAPES];
+
+//one call covers BENCH_BATCH points, reported per point so it compares with the single point calls
+#define BENCH_BATCH 1000
+#define BENCH_BATCH_CALLS (BENCH_CALLS / BENCH_BATCH)
+#define BENCH_BATCH_RUN(name, expression) do { \
+    clock_t start = clock(); \
+    for(int i = 0; i < BENCH_BATCH_CALLS; i++) { \
+        int index = (i * 13) & (BENCH_SHAPES - 1); \
+        int count = BENCH_BATCH - (i & 7);/*odd counts too, so the scalar tails run*/ \
+        index = index + count > BENCH_SHAPES ? 0 : index; \
+        sink += (float)(expression); \
+    } \
+    bench_report(name, clock() - start); \
+} while(0)
+
+//every batch call on backend, whose results must equal the scalar ones, returns the mismatches
+static int bench_batch(HF_BatchBackend backend, const char* backend_name) {
+    static float expected_x[BENCH_SHAPES];
+    static float expected_y[BENCH_SHAPES];
+    static int expected_hits[BENCH_SHAPES];
+    char name[64];
+    int mismatches = 0;
+
+    HF_Line line = lines[0];
+    HF_Vec2f point = circles[0].position;
+    for(int count = 0; count <= 67; count += 67) {//67 has tails on every backend
+        hf_batch_select(HF_BATCH_BACKEND_Scalar);
+        hf_batch_rotate(batch_x, batch_y, expected_x, expected_y, count, 0.6f, 0.8f);
+        hf_batch_translate_xy(batch_x, expected_y + count, count / 2, point);//batch_x read as x, y pairs
+        int expected_circle = hf_batch_circles_contain(batch_x + 1, batch_y, batch_radius, count, point);
+        int expected_hit_count = hf_batch_lines_hit(line, batch_x, batch_y, batch_end_x, batch_end_y, count, expected_hits);
+
+        hf_batch_select(backend);
+        hf_batch_rotate(batch_x, batch_y, batch_out_x, batch_out_y, count, 0.6f, 0.8f);
+        hf_batch_translate_xy(batch_x, batch_out_y + count, count / 2, point);
+        for(int i = 0; i < count; i++) {
+            mismatches += batch_out_x[i] != expected_x[i] || batch_out_y[i] != expected_y[i];
+        }
+        for(int i = count; i < count + count / 2 * 2; i++) {
+            mismatches += batch_out_y[i] != expected_y[i];
+        }
+        mismatches += hf_batch_circles_contain(batch_x + 1, batch_y, batch_radius, count, point) != expected_circle;
+        int hit_count = hf_batch_lines_hit(line, batch_x, batch_y, batch_end_x, batch_end_y, count, batch_hits);
+        mismatches += hit_count != expected_hit_count;
+        for(int i = 0; i < hit_count && i < expected_hit_count; i++) {
+            mismatches += batch_hits[i] != expected_hits[i];
+        }
+    }
+    for(int i = 0; i < BENCH_SHAPES; i++) {//the whole line set against its own first line, like vine_collision_self
+        mismatches += (hf_intersection_lines(line, lines[i], NULL) ? 1 : 0) != (hf_batch_lines_hit(line, &batch_x[i], &batch_y[i], &batch_end_x[i], &batch_end_y[i], 1, batch_hits) ? 1 : 0);
+    }
+
+    snprintf(name, sizeof(name), "batch %s, translate", backend_name);
+    BENCH_BATCH_RUN(name, (hf_batch_translate(batch_x + index, batch_y + index, batch_out_x + index, batch_out_y + index, count, point), batch_out_x[index]));
+    snprintf(name, sizeof(name), "batch %s, sqr distance", backend_name);
+    BENCH_BATCH_RUN(name, (hf_batch_sqr_distance(batch_x + index, batch_y + index, batch_out_x + index, count, point), batch_out_x[index]));
+    snprintf(name, sizeof(name), "batch %s, circles contain", backend_name);
+    BENCH_BATCH_RUN(name, hf_batch_circles_contain(batch_x + index, batch_y + index, batch_radius + index, count, (HF_Vec2f) { -1.f, -1.f }));
+    snprintf(name, sizeof(name), "batch %s, lines hit", backend_name);
+    BENCH_BATCH_RUN(name, hf_batch_lines_hit(lines[index], batch_x + index, batch_y + index, batch_end_x + index, batch_end_y + index, count, batch_hits));
+    return mismatches;
+}
+
+//calls per second of every hf_intersection primitive, and the kernels before they stopped calling trig functions
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    srand(23);
+    bench_setup_shapes(random_float, lines, triangles, circles, points);
+
+    //the new kernels must agree with the old ones
+    int hits = 0;
+    int mismatches = 0;
+    float max_error = 0.f;
+    for(int i = 0; i < BENCH_SHAPES; i++) {
+        HF_Line a = lines[i];
+        HF_Line b = lines[(i + 1) & (BENCH_SHAPES - 1)];
+        HF_Vec2f hit_new;
+        HF_Vec2f hit_old;
+        bool new_hit = hf_intersection_lines(a, b, &hit_new);
+        bool old_hit = trig_intersection_lines(a, b, &hit_old);
+        mismatches += new_hit != old_hit;
+        if(new_hit && old_hit) {
+            hits++;
+            max_error = fmaxf(max_error, hf_vec2f_magnitude(hf_vec2f_subtract(hit_new, hit_old)));
+        }
+
+        HF_Vec2f closest_new = hf_line_closest_point(a, points[i]);
+        HF_Vec2f closest_old = trig_line_closest_point(a, points[i]);
+        max_error = fmaxf(max_error, hf_vec2f_magnitude(hf_vec2f_subtract(closest_new, closest_old)));
+    }
+    printf("%d line pairs, %d hits, %d hit mismatches, max point difference %g\n", BENCH_SHAPES, hits, mismatches, (double)max_error);
+
+    BENCH("lines, no hit point", hf_intersection_lines(lines[index], lines[next], NULL));
+    BENCH("lines", lines_hit(lines[index], lines[next]));
+    BENCH("lines, trig (old)", trig_lines_hit(lines[index], lines[next]));
+    BENCH("line closest point", hf_line_closest_point(lines[index], points[next]).x);
+    BENCH("line closest point, trig (old)", trig_line_closest_point(lines[index], points[next]).x);
+    BENCH("line circle", line_circle_hit(lines[index], circles[next]));
+    BENCH("line triangle", line_triangle_hit(lines[index], triangles[next]));
+    BENCH("triangle circle", triangle_circle_hit(triangles[index], circles[next]));
+    BENCH("triangles", triangles_hit(triangles[index], triangles[next]));
+    BENCH("circles", circles_hit(circles[index], circles[next]));
+
+    for(int i = 0; i < BENCH_SHAPES; i++) {
+        batch_x[i] = lines[i].start.x;
+        batch_y[i] = lines[i].start.y;
+        batch_end_x[i] = lines[i].end.x;
+        batch_end_y[i] = lines[i].end.y;
+        batch_radius[i] = circles[i].radius;
+    }
+    const char* backend_names[] = HF_BATCH_BACKEND_NAMES;
+    for(int backend = 0; backend < HF_BATCH_BACKEND_Count; backend++) {
+        if(!hf_batch_compiled((HF_BatchBackend)backend) || !batch_cpu_has((HF_BatchBackend)backend)) {
+            printf("batch %s: not available\n", backend_names[backend]);
+            continue;
+        }
+        int batch_mismatches = bench_batch((HF_BatchBackend)backend, backend_names[backend]);
+        printf("batch %s: %d mismatches with scalar\n", backend_names[backend], batch_mismatches);
+        mismatches += batch_mismatches;
+    }
+
+    printf("(sink %g)\n", (double)sink);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,69 @@
+#ifndef HF_BENCH_SHAPES_H
+#define HF_BENCH_SHAPES_H
+
+#include "../include/hf_intersection.h"
+
+//inputs shared by hf_bench and trepadeira_bench, so the two time the primitives on the same kind of shapes
+#define BENCH_SHAPES 4096//power of two, inputs are cycled so they stay in cache
+#define BENCH_AREA 1000.f
+
+//each bench brings its own generator, returns a float from 0 to max
+typedef float (*BenchRandom)(float max);
+
+//short segments and small shapes, like the vine lines and bubbles the game tests
+static inline HF_Vec2f bench_random_near(BenchRandom random, HF_Vec2f point, float distance) {
+    return (HF_Vec2f) { point.x + random(distance * 2.f) - distance, point.y + random(distance * 2.f) - distance };
+}
+
+static inline void bench_setup_shapes(BenchRandom random, HF_Line* lines, HF_Triangle* triangles, HF_Circle* circles, HF_Vec2f* points) {
+    for(int i = 0; i < BENCH_SHAPES; i++) {
+        //shapes cluster in a small area so pairs overlap often
+        HF_Vec2f center = bench_random_near(random, (HF_Vec2f) { BENCH_AREA / 2.f, BENCH_AREA / 2.f }, 10.f);
+        lines[i] = (HF_Line) { center, bench_random_near(random, center, 30.f) };
+        triangles[i] = (HF_Triangle) { bench_random_near(random, center, 30.f), bench_random_near(random, center, 30.f), bench_random_near(random, center, 30.f) };
+        circles[i] = (HF_Circle) { bench_random_near(random, center, 20.f), 5.f + random(20.f) };
+        points[i] = (HF_Vec2f) { random(BENCH_AREA), random(BENCH_AREA) };
+    }
+}
+
+//adds expression to sum for each of iterations, index and next pair up neighbouring shapes, close enough that a good part of the pairs hit
+#define BENCH_PAIRS(sum, iterations, expression) \
+    for(int i = 0; i < (iterations); i++) { \
+        int index = i & (BENCH_SHAPES - 1); \
+        int next = (i + 1) & (BENCH_SHAPES - 1); \
+        (void)next; \
+        (sum) += (float)(expression); \
+    }
+
+//each primitive with its hit point requested, reduced to a float for the sum
+static inline float lines_hit(HF_Line a, HF_Line b) {
+    HF_Vec2f hit;
+    return hf_intersection_lines(a, b, &hit) ? hit.x : 0.f;
+}
+
+static inline float triangles_hit(HF_Triangle a, HF_Triangle b) {
+    HF_Vec2f hit;
+    return hf_intersection_triangles(a, b, &hit) ? hit.x : 0.f;
+}
+
+static inline float circles_hit(HF_Circle a, HF_Circle b) {
+    HF_Vec2f hit;
+    return hf_intersection_circles(a, b, &hit) ? hit.x : 0.f;
+}
+
+static inline float line_triangle_hit(HF_Line line, HF_Triangle triangle) {
+    HF_Vec2f hit;
+    return hf_intersection_line_triangle(line, triangle, &hit) ? hit.x : 0.f;
+}
+
+static inline float line_circle_hit(HF_Line line, HF_Circle circle) {
+    HF_Vec2f hit;
+    return hf_intersection_line_circle(line, circle, &hit) ? hit.x : 0.f;
+}
+
+static inline float triangle_circle_hit(HF_Triangle triangle, HF_Circle circle) {
+    HF_Vec2f hit;
+    return hf_intersection_triangle_circle(triangle, circle, &hit) ? hit.x : 0.f;
+}
+
+#endif//HF_BENCH_SHAPES_H
@@ -0,0 +1,12 @@
+#ifndef HF_API_H
+#define HF_API_H
+
+//with HF_INLINE defined the headers carry the definitions as static inline, so vector ops inline without LTO
+//the hf_math library is always built without it, for users linking against it
+#ifdef HF_INLINE
+#define HF_API static inline
+#else
+#define HF_API
+#endif
+
+#endif//HF_API_H
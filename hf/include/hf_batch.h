@@ -0,0 +1,41 @@
+#ifndef HF_BATCH_H
+#define HF_BATCH_H
+
+#include <stdbool.h>
+#include "hf_vec.h"
+#include "hf_line.h"
+
+//the same vector work over many points at once, on structure of arrays: point i is (x[i], y[i])
+//every call goes through the kernels of the selected backend, scalar until hf_batch_select picks another
+//results match the one point at a time functions, out arrays may be the input arrays
+
+typedef enum HF_BatchBackend_t {
+    HF_BATCH_BACKEND_Scalar,
+    HF_BATCH_BACKEND_SSE2,
+    HF_BATCH_BACKEND_AVX2,
+    HF_BATCH_BACKEND_NEON,
+    HF_BATCH_BACKEND_Count,
+} HF_BatchBackend;
+
+#define HF_BATCH_BACKEND_NAMES { "scalar", "sse2", "avx2", "neon" }
+
+//whether this build has kernels for backend, the cpu running it may still lack the instructions
+bool hf_batch_compiled(HF_BatchBackend backend);
+//hf_math doesn't detect the cpu, the caller has to know it supports backend, false keeps the current one
+bool hf_batch_select(HF_BatchBackend backend);
+//the widest compiled backend among the ones the cpu has, e.g. from SDL_HasSSE2, SDL_HasAVX2 and SDL_HasNEON
+HF_BatchBackend hf_batch_select_best(bool has_sse2, bool has_avx2, bool has_neon);
+HF_BatchBackend hf_batch_backend(void);
+
+void hf_batch_translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset);
+//points stored x, y, x, y, like SDL_FPoint arrays
+void hf_batch_translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset);
+void hf_batch_rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad);
+void hf_batch_dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count);
+void hf_batch_sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point);
+//index of the first circle with point strictly inside, -1 when there is none
+int hf_batch_circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point);
+//writes the indices of the segments line crosses, same test as hf_intersection_lines(line, segment), returns how many
+int hf_batch_lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits);
+
+#endif//HF_BATCH_H
@@ -3,12 +3,17 @@
 
 #include <stdbool.h>
 #include "hf_vec.h"
+#include "hf_api.h"
 
 typedef struct HF_Line_t {
     HF_Vec2f start;
     HF_Vec2f end;
 } HF_Line;
 
-HF_Vec2f hf_line_closest_point(HF_Line line, HF_Vec2f point);
+HF_API HF_Vec2f hf_line_closest_point(HF_Line line, HF_Vec2f point);
+
+#ifdef HF_INLINE//the definitions come along, see hf_api.h
+#include "../src/hf_line.c"
+#endif
 
 #endif//HF_LINE_H
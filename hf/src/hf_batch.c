@@ -0,0 +1,154 @@
+#include <stddef.h>
+
+#include "hf_batch_kernels.h"
+
+//scalar kernels, the fallback and the tails of the vector ones, written like the one point functions so results match
+static void hf_batch__translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset) {
+    for(int i = 0; i < count; i++) {
+        out_x[i] = x[i] + offset.x;
+        out_y[i] = y[i] + offset.y;
+    }
+}
+
+static void hf_batch__translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset) {
+    for(int i = 0; i < count; i++) {
+        out_xy[i * 2] = xy[i * 2] + offset.x;
+        out_xy[i * 2 + 1] = xy[i * 2 + 1] + offset.y;
+    }
+}
+
+static void hf_batch__rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad) {
+    for(int i = 0; i < count; i++) {
+        HF_Vec2f vec = { x[i], y[i] };//read both first, out may be the input
+        out_x[i] = vec.x * cos_rad - vec.y * sin_rad;
+        out_y[i] = vec.y * cos_rad + vec.x * sin_rad;
+    }
+}
+
+static void hf_batch__dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count) {
+    for(int i = 0; i < count; i++) {
+        out[i] = a_x[i] * b_x[i] + a_y[i] * b_y[i];
+    }
+}
+
+static void hf_batch__sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point) {
+    for(int i = 0; i < count; i++) {
+        float vec_x = x[i] - point.x;
+        float vec_y = y[i] - point.y;
+        out[i] = vec_x * vec_x + vec_y * vec_y;
+    }
+}
+
+static int hf_batch__circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point) {
+    for(int i = 0; i < count; i++) {
+        float vec_x = x[i] - point.x;
+        float vec_y = y[i] - point.y;
+        if(vec_x * vec_x + vec_y * vec_y < radius[i] * radius[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int hf_batch__lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits) {
+    HF_Vec2f a_vec = hf_vec2f_subtract(line.end, line.start);
+    HF_Vec2f a_vec90 = { a_vec.y, -a_vec.x };
+
+    int hit_count = 0;
+    for(int i = 0; i < count; i++) {
+        float b_start_side = a_vec90.x * (start_x[i] - line.start.x) + a_vec90.y * (start_y[i] - line.start.y);
+        float b_end_side = a_vec90.x * (end_x[i] - line.start.x) + a_vec90.y * (end_y[i] - line.start.y);
+        HF_Vec2f b_vec90 = { end_y[i] - start_y[i], -(end_x[i] - start_x[i]) };
+        float a_start_side = b_vec90.x * (line.start.x - start_x[i]) + b_vec90.y * (line.start.y - start_y[i]);
+        float a_end_side = b_vec90.x * (line.end.x - start_x[i]) + b_vec90.y * (line.end.y - start_y[i]);
+        if((b_start_side > 0.f) != (b_end_side > 0.f) && (a_start_side > 0.f) != (a_end_side > 0.f)) {
+            hits[hit_count] = i;
+            hit_count++;
+        }
+    }
+    return hit_count;
+}
+
+const HF_BatchKernels hf_batch_kernels_scalar = {
+    .translate = hf_batch__translate,
+    .translate_xy = hf_batch__translate_xy,
+    .rotate = hf_batch__rotate,
+    .dot = hf_batch__dot,
+    .sqr_distance = hf_batch__sqr_distance,
+    .circles_contain = hf_batch__circles_contain,
+    .lines_hit = hf_batch__lines_hit,
+};
+
+//chosen once at startup, before anything calls the kernels from another thread
+static const HF_BatchKernels* hf_batch__kernels = &hf_batch_kernels_scalar;
+static HF_BatchBackend hf_batch__backend = HF_BATCH_BACKEND_Scalar;
+
+static const HF_BatchKernels* hf_batch__backend_kernels(HF_BatchBackend backend) {
+    switch(backend) {
+    case HF_BATCH_BACKEND_Scalar:
+        return &hf_batch_kernels_scalar;
+    case HF_BATCH_BACKEND_SSE2:
+        return hf_batch_kernels_sse2;
+    case HF_BATCH_BACKEND_AVX2:
+        return hf_batch_kernels_avx2;
+    case HF_BATCH_BACKEND_NEON:
+        return hf_batch_kernels_neon;
+    default:
+        return NULL;
+    }
+}
+
+bool hf_batch_compiled(HF_BatchBackend backend) {
+    return hf_batch__backend_kernels(backend) != NULL;
+}
+
+bool hf_batch_select(HF_BatchBackend backend) {
+    const HF_BatchKernels* kernels = hf_batch__backend_kernels(backend);
+    if(!kernels) {
+        return false;
+    }
+    hf_batch__kernels = kernels;
+    hf_batch__backend = backend;
+    return true;
+}
+
+HF_BatchBackend hf_batch_select_best(bool has_sse2, bool has_avx2, bool has_neon) {
+    if(!(has_avx2 && hf_batch_select(HF_BATCH_BACKEND_AVX2))
+       && !(has_sse2 && hf_batch_select(HF_BATCH_BACKEND_SSE2))
+       && !(has_neon && hf_batch_select(HF_BATCH_BACKEND_NEON))) {
+        hf_batch_select(HF_BATCH_BACKEND_Scalar);
+    }
+    return hf_batch__backend;
+}
+
+HF_BatchBackend hf_batch_backend(void) {
+    return hf_batch__backend;
+}
+
+void hf_batch_translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset) {
+    hf_batch__kernels->translate(x, y, out_x, out_y, count, offset);
+}
+
+void hf_batch_translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset) {
+    hf_batch__kernels->translate_xy(xy, out_xy, count, offset);
+}
+
+void hf_batch_rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad) {
+    hf_batch__kernels->rotate(x, y, out_x, out_y, count, sin_rad, cos_rad);
+}
+
+void hf_batch_dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count) {
+    hf_batch__kernels->dot(a_x, a_y, b_x, b_y, out, count);
+}
+
+void hf_batch_sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point) {
+    hf_batch__kernels->sqr_distance(x, y, out, count, point);
+}
+
+int hf_batch_circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point) {
+    return hf_batch__kernels->circles_contain(x, y, radius, count, point);
+}
+
+int hf_batch_lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits) {
+    return hf_batch__kernels->lines_hit(line, start_x, start_y, end_x, end_y, count, hits);
+}
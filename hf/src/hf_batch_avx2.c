@@ -0,0 +1,145 @@
+#include <stddef.h>
+
+#include "hf_batch_kernels.h"
+
+//built with -mavx2 (see hf/CMakeLists.txt), only called after hf_batch_select was told the cpu has it
+#ifdef __AVX2__
+#include <immintrin.h>
+
+//8 points per step, same operations in the same order as the scalar kernels so results match them
+static void hf_batch_avx2__translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset) {
+    __m256 offset_x = _mm256_set1_ps(offset.x);
+    __m256 offset_y = _mm256_set1_ps(offset.y);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out_x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), offset_x));
+        _mm256_storeu_ps(out_y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), offset_y));
+    }
+    hf_batch_kernels_scalar.translate(x + i, y + i, out_x + i, out_y + i, count - i, offset);
+}
+
+static void hf_batch_avx2__translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset) {
+    __m256 offset_xy = _mm256_setr_ps(offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        _mm256_storeu_ps(out_xy + i * 2, _mm256_add_ps(_mm256_loadu_ps(xy + i * 2), offset_xy));
+    }
+    hf_batch_kernels_scalar.translate_xy(xy + i * 2, out_xy + i * 2, count - i, offset);
+}
+
+static void hf_batch_avx2__rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad) {
+    __m256 sin_v = _mm256_set1_ps(sin_rad);
+    __m256 cos_v = _mm256_set1_ps(cos_rad);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 vec_x = _mm256_loadu_ps(x + i);
+        __m256 vec_y = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(out_x + i, _mm256_sub_ps(_mm256_mul_ps(vec_x, cos_v), _mm256_mul_ps(vec_y, sin_v)));
+        _mm256_storeu_ps(out_y + i, _mm256_add_ps(_mm256_mul_ps(vec_y, cos_v), _mm256_mul_ps(vec_x, sin_v)));
+    }
+    hf_batch_kernels_scalar.rotate(x + i, y + i, out_x + i, out_y + i, count - i, sin_rad, cos_rad);
+}
+
+static void hf_batch_avx2__dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_mul_ps(_mm256_loadu_ps(a_x + i), _mm256_loadu_ps(b_x + i));
+        __m256 y = _mm256_mul_ps(_mm256_loadu_ps(a_y + i), _mm256_loadu_ps(b_y + i));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(x, y));
+    }
+    hf_batch_kernels_scalar.dot(a_x + i, a_y + i, b_x + i, b_y + i, out + i, count - i);
+}
+
+static void hf_batch_avx2__sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point) {
+    __m256 point_x = _mm256_set1_ps(point.x);
+    __m256 point_y = _mm256_set1_ps(point.y);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 vec_x = _mm256_sub_ps(_mm256_loadu_ps(x + i), point_x);
+        __m256 vec_y = _mm256_sub_ps(_mm256_loadu_ps(y + i), point_y);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(vec_x, vec_x), _mm256_mul_ps(vec_y, vec_y)));
+    }
+    hf_batch_kernels_scalar.sqr_distance(x + i, y + i, out + i, count - i, point);
+}
+
+static int hf_batch_avx2__circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point) {
+    __m256 point_x = _mm256_set1_ps(point.x);
+    __m256 point_y = _mm256_set1_ps(point.y);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 vec_x = _mm256_sub_ps(_mm256_loadu_ps(x + i), point_x);
+        __m256 vec_y = _mm256_sub_ps(_mm256_loadu_ps(y + i), point_y);
+        __m256 sqr_distance = _mm256_add_ps(_mm256_mul_ps(vec_x, vec_x), _mm256_mul_ps(vec_y, vec_y));
+        __m256 r = _mm256_loadu_ps(radius + i);
+        int inside = _mm256_movemask_ps(_mm256_cmp_ps(sqr_distance, _mm256_mul_ps(r, r), _CMP_LT_OQ));
+        for(int j = 0; inside; j++, inside >>= 1) {//lowest lane first, the same circle the scalar loop finds
+            if(inside & 1) {
+                return i + j;
+            }
+        }
+    }
+    int found = hf_batch_kernels_scalar.circles_contain(x + i, y + i, radius + i, count - i, point);
+    return found < 0 ? -1 : i + found;
+}
+
+static int hf_batch_avx2__lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits) {
+    HF_Vec2f a_vec = hf_vec2f_subtract(line.end, line.start);
+    __m256 a_vec90_x = _mm256_set1_ps(a_vec.y);
+    __m256 a_vec90_y = _mm256_set1_ps(-a_vec.x);
+    __m256 line_start_x = _mm256_set1_ps(line.start.x);
+    __m256 line_start_y = _mm256_set1_ps(line.start.y);
+    __m256 line_end_x = _mm256_set1_ps(line.end.x);
+    __m256 line_end_y = _mm256_set1_ps(line.end.y);
+    __m256 sign = _mm256_set1_ps(-0.f);
+    __m256 zero = _mm256_setzero_ps();
+
+    int hit_count = 0;
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 s_x = _mm256_loadu_ps(start_x + i);
+        __m256 s_y = _mm256_loadu_ps(start_y + i);
+        __m256 e_x = _mm256_loadu_ps(end_x + i);
+        __m256 e_y = _mm256_loadu_ps(end_y + i);
+
+        __m256 b_start_side = _mm256_add_ps(_mm256_mul_ps(a_vec90_x, _mm256_sub_ps(s_x, line_start_x)), _mm256_mul_ps(a_vec90_y, _mm256_sub_ps(s_y, line_start_y)));
+        __m256 b_end_side = _mm256_add_ps(_mm256_mul_ps(a_vec90_x, _mm256_sub_ps(e_x, line_start_x)), _mm256_mul_ps(a_vec90_y, _mm256_sub_ps(e_y, line_start_y)));
+        __m256 b_vec90_x = _mm256_sub_ps(e_y, s_y);
+        __m256 b_vec90_y = _mm256_xor_ps(_mm256_sub_ps(e_x, s_x), sign);
+        __m256 a_start_side = _mm256_add_ps(_mm256_mul_ps(b_vec90_x, _mm256_sub_ps(line_start_x, s_x)), _mm256_mul_ps(b_vec90_y, _mm256_sub_ps(line_start_y, s_y)));
+        __m256 a_end_side = _mm256_add_ps(_mm256_mul_ps(b_vec90_x, _mm256_sub_ps(line_end_x, s_x)), _mm256_mul_ps(b_vec90_y, _mm256_sub_ps(line_end_y, s_y)));
+
+        __m256 b_crosses = _mm256_xor_ps(_mm256_cmp_ps(b_start_side, zero, _CMP_GT_OQ), _mm256_cmp_ps(b_end_side, zero, _CMP_GT_OQ));
+        __m256 a_crosses = _mm256_xor_ps(_mm256_cmp_ps(a_start_side, zero, _CMP_GT_OQ), _mm256_cmp_ps(a_end_side, zero, _CMP_GT_OQ));
+        int crossed = _mm256_movemask_ps(_mm256_and_ps(b_crosses, a_crosses));
+        for(int j = 0; crossed; j++, crossed >>= 1) {
+            if(crossed & 1) {
+                hits[hit_count] = i + j;
+                hit_count++;
+            }
+        }
+    }
+
+    int tail_count = hf_batch_kernels_scalar.lines_hit(line, start_x + i, start_y + i, end_x + i, end_y + i, count - i, hits + hit_count);
+    for(int j = hit_count; j < hit_count + tail_count; j++) {
+        hits[j] += i;
+    }
+    return hit_count + tail_count;
+}
+
+static const HF_BatchKernels hf_batch_avx2__kernels = {
+    .translate = hf_batch_avx2__translate,
+    .translate_xy = hf_batch_avx2__translate_xy,
+    .rotate = hf_batch_avx2__rotate,
+    .dot = hf_batch_avx2__dot,
+    .sqr_distance = hf_batch_avx2__sqr_distance,
+    .circles_contain = hf_batch_avx2__circles_contain,
+    .lines_hit = hf_batch_avx2__lines_hit,
+};
+
+const HF_BatchKernels* const hf_batch_kernels_avx2 = &hf_batch_avx2__kernels;
+
+#else
+
+const HF_BatchKernels* const hf_batch_kernels_avx2 = NULL;
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef HF_BATCH_KERNELS_H
+#define HF_BATCH_KERNELS_H
+
+#include "../include/hf_batch.h"
+
+//one table per backend, the vector kernels hand the last count % width points to the scalar ones
+typedef struct HF_BatchKernels_t {
+    void (*translate)(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset);
+    void (*translate_xy)(const float* xy, float* out_xy, int count, HF_Vec2f offset);
+    void (*rotate)(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad);
+    void (*dot)(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count);
+    void (*sqr_distance)(const float* x, const float* y, float* out, int count, HF_Vec2f point);
+    int (*circles_contain)(const float* x, const float* y, const float* radius, int count, HF_Vec2f point);
+    int (*lines_hit)(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits);
+} HF_BatchKernels;
+
+extern const HF_BatchKernels hf_batch_kernels_scalar;
+//NULL when the build target can't have them
+extern const HF_BatchKernels* const hf_batch_kernels_sse2;
+extern const HF_BatchKernels* const hf_batch_kernels_avx2;
+extern const HF_BatchKernels* const hf_batch_kernels_neon;
+
+#endif//HF_BATCH_KERNELS_H
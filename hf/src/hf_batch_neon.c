@@ -0,0 +1,156 @@
+#include <stddef.h>
+
+#include "hf_batch_kernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+//4 points per step, multiplies and adds stay separate (no vmla/vfma, and -ffp-contract=off so the compiler
+//doesn't fuse them either) so results match the scalar kernels
+static void hf_batch_neon__translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset) {
+    float32x4_t offset_x = vdupq_n_f32(offset.x);
+    float32x4_t offset_y = vdupq_n_f32(offset.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        vst1q_f32(out_x + i, vaddq_f32(vld1q_f32(x + i), offset_x));
+        vst1q_f32(out_y + i, vaddq_f32(vld1q_f32(y + i), offset_y));
+    }
+    hf_batch_kernels_scalar.translate(x + i, y + i, out_x + i, out_y + i, count - i, offset);
+}
+
+static void hf_batch_neon__translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset) {
+    float32x4_t offset_x = vdupq_n_f32(offset.x);
+    float32x4_t offset_y = vdupq_n_f32(offset.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4x2_t vec = vld2q_f32(xy + i * 2);//deinterleaves into x and y
+        vec.val[0] = vaddq_f32(vec.val[0], offset_x);
+        vec.val[1] = vaddq_f32(vec.val[1], offset_y);
+        vst2q_f32(out_xy + i * 2, vec);
+    }
+    hf_batch_kernels_scalar.translate_xy(xy + i * 2, out_xy + i * 2, count - i, offset);
+}
+
+static void hf_batch_neon__rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad) {
+    float32x4_t sin_v = vdupq_n_f32(sin_rad);
+    float32x4_t cos_v = vdupq_n_f32(cos_rad);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t vec_x = vld1q_f32(x + i);
+        float32x4_t vec_y = vld1q_f32(y + i);
+        vst1q_f32(out_x + i, vsubq_f32(vmulq_f32(vec_x, cos_v), vmulq_f32(vec_y, sin_v)));
+        vst1q_f32(out_y + i, vaddq_f32(vmulq_f32(vec_y, cos_v), vmulq_f32(vec_x, sin_v)));
+    }
+    hf_batch_kernels_scalar.rotate(x + i, y + i, out_x + i, out_y + i, count - i, sin_rad, cos_rad);
+}
+
+static void hf_batch_neon__dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count) {
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t x = vmulq_f32(vld1q_f32(a_x + i), vld1q_f32(b_x + i));
+        float32x4_t y = vmulq_f32(vld1q_f32(a_y + i), vld1q_f32(b_y + i));
+        vst1q_f32(out + i, vaddq_f32(x, y));
+    }
+    hf_batch_kernels_scalar.dot(a_x + i, a_y + i, b_x + i, b_y + i, out + i, count - i);
+}
+
+static void hf_batch_neon__sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point) {
+    float32x4_t point_x = vdupq_n_f32(point.x);
+    float32x4_t point_y = vdupq_n_f32(point.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t vec_x = vsubq_f32(vld1q_f32(x + i), point_x);
+        float32x4_t vec_y = vsubq_f32(vld1q_f32(y + i), point_y);
+        vst1q_f32(out + i, vaddq_f32(vmulq_f32(vec_x, vec_x), vmulq_f32(vec_y, vec_y)));
+    }
+    hf_batch_kernels_scalar.sqr_distance(x + i, y + i, out + i, count - i, point);
+}
+
+//one bit per lane like _mm_movemask_ps, lane 0 in bit 0
+static int hf_batch_neon__lane_bits(uint32x4_t mask) {
+    return (int)((vgetq_lane_u32(mask, 0) & 1u)
+        | (vgetq_lane_u32(mask, 1) & 2u)
+        | (vgetq_lane_u32(mask, 2) & 4u)
+        | (vgetq_lane_u32(mask, 3) & 8u));
+}
+
+static int hf_batch_neon__circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point) {
+    float32x4_t point_x = vdupq_n_f32(point.x);
+    float32x4_t point_y = vdupq_n_f32(point.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t vec_x = vsubq_f32(vld1q_f32(x + i), point_x);
+        float32x4_t vec_y = vsubq_f32(vld1q_f32(y + i), point_y);
+        float32x4_t sqr_distance = vaddq_f32(vmulq_f32(vec_x, vec_x), vmulq_f32(vec_y, vec_y));
+        float32x4_t r = vld1q_f32(radius + i);
+        int inside = hf_batch_neon__lane_bits(vcltq_f32(sqr_distance, vmulq_f32(r, r)));
+        for(int j = 0; inside; j++, inside >>= 1) {//lowest lane first, the same circle the scalar loop finds
+            if(inside & 1) {
+                return i + j;
+            }
+        }
+    }
+    int found = hf_batch_kernels_scalar.circles_contain(x + i, y + i, radius + i, count - i, point);
+    return found < 0 ? -1 : i + found;
+}
+
+static int hf_batch_neon__lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits) {
+    HF_Vec2f a_vec = hf_vec2f_subtract(line.end, line.start);
+    float32x4_t a_vec90_x = vdupq_n_f32(a_vec.y);
+    float32x4_t a_vec90_y = vdupq_n_f32(-a_vec.x);
+    float32x4_t line_start_x = vdupq_n_f32(line.start.x);
+    float32x4_t line_start_y = vdupq_n_f32(line.start.y);
+    float32x4_t line_end_x = vdupq_n_f32(line.end.x);
+    float32x4_t line_end_y = vdupq_n_f32(line.end.y);
+    float32x4_t zero = vdupq_n_f32(0.f);
+
+    int hit_count = 0;
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t s_x = vld1q_f32(start_x + i);
+        float32x4_t s_y = vld1q_f32(start_y + i);
+        float32x4_t e_x = vld1q_f32(end_x + i);
+        float32x4_t e_y = vld1q_f32(end_y + i);
+
+        float32x4_t b_start_side = vaddq_f32(vmulq_f32(a_vec90_x, vsubq_f32(s_x, line_start_x)), vmulq_f32(a_vec90_y, vsubq_f32(s_y, line_start_y)));
+        float32x4_t b_end_side = vaddq_f32(vmulq_f32(a_vec90_x, vsubq_f32(e_x, line_start_x)), vmulq_f32(a_vec90_y, vsubq_f32(e_y, line_start_y)));
+        float32x4_t b_vec90_x = vsubq_f32(e_y, s_y);
+        float32x4_t b_vec90_y = vnegq_f32(vsubq_f32(e_x, s_x));
+        float32x4_t a_start_side = vaddq_f32(vmulq_f32(b_vec90_x, vsubq_f32(line_start_x, s_x)), vmulq_f32(b_vec90_y, vsubq_f32(line_start_y, s_y)));
+        float32x4_t a_end_side = vaddq_f32(vmulq_f32(b_vec90_x, vsubq_f32(line_end_x, s_x)), vmulq_f32(b_vec90_y, vsubq_f32(line_end_y, s_y)));
+
+        uint32x4_t b_crosses = veorq_u32(vcgtq_f32(b_start_side, zero), vcgtq_f32(b_end_side, zero));
+        uint32x4_t a_crosses = veorq_u32(vcgtq_f32(a_start_side, zero), vcgtq_f32(a_end_side, zero));
+        int crossed = hf_batch_neon__lane_bits(vandq_u32(b_crosses, a_crosses));
+        for(int j = 0; crossed; j++, crossed >>= 1) {
+            if(crossed & 1) {
+                hits[hit_count] = i + j;
+                hit_count++;
+            }
+        }
+    }
+
+    int tail_count = hf_batch_kernels_scalar.lines_hit(line, start_x + i, start_y + i, end_x + i, end_y + i, count - i, hits + hit_count);
+    for(int j = hit_count; j < hit_count + tail_count; j++) {
+        hits[j] += i;
+    }
+    return hit_count + tail_count;
+}
+
+static const HF_BatchKernels hf_batch_neon__kernels = {
+    .translate = hf_batch_neon__translate,
+    .translate_xy = hf_batch_neon__translate_xy,
+    .rotate = hf_batch_neon__rotate,
+    .dot = hf_batch_neon__dot,
+    .sqr_distance = hf_batch_neon__sqr_distance,
+    .circles_contain = hf_batch_neon__circles_contain,
+    .lines_hit = hf_batch_neon__lines_hit,
+};
+
+const HF_BatchKernels* const hf_batch_kernels_neon = &hf_batch_neon__kernels;
+
+#else
+
+const HF_BatchKernels* const hf_batch_kernels_neon = NULL;
+
+#endif
@@ -0,0 +1,144 @@
+#include <stddef.h>
+
+#include "hf_batch_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+//4 points per step, same operations in the same order as the scalar kernels so results match them
+static void hf_batch_sse2__translate(const float* x, const float* y, float* out_x, float* out_y, int count, HF_Vec2f offset) {
+    __m128 offset_x = _mm_set1_ps(offset.x);
+    __m128 offset_y = _mm_set1_ps(offset.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out_x + i, _mm_add_ps(_mm_loadu_ps(x + i), offset_x));
+        _mm_storeu_ps(out_y + i, _mm_add_ps(_mm_loadu_ps(y + i), offset_y));
+    }
+    hf_batch_kernels_scalar.translate(x + i, y + i, out_x + i, out_y + i, count - i, offset);
+}
+
+static void hf_batch_sse2__translate_xy(const float* xy, float* out_xy, int count, HF_Vec2f offset) {
+    __m128 offset_xy = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+    int i = 0;
+    for(; i + 2 <= count; i += 2) {
+        _mm_storeu_ps(out_xy + i * 2, _mm_add_ps(_mm_loadu_ps(xy + i * 2), offset_xy));
+    }
+    hf_batch_kernels_scalar.translate_xy(xy + i * 2, out_xy + i * 2, count - i, offset);
+}
+
+static void hf_batch_sse2__rotate(const float* x, const float* y, float* out_x, float* out_y, int count, float sin_rad, float cos_rad) {
+    __m128 sin_v = _mm_set1_ps(sin_rad);
+    __m128 cos_v = _mm_set1_ps(cos_rad);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 vec_x = _mm_loadu_ps(x + i);
+        __m128 vec_y = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(out_x + i, _mm_sub_ps(_mm_mul_ps(vec_x, cos_v), _mm_mul_ps(vec_y, sin_v)));
+        _mm_storeu_ps(out_y + i, _mm_add_ps(_mm_mul_ps(vec_y, cos_v), _mm_mul_ps(vec_x, sin_v)));
+    }
+    hf_batch_kernels_scalar.rotate(x + i, y + i, out_x + i, out_y + i, count - i, sin_rad, cos_rad);
+}
+
+static void hf_batch_sse2__dot(const float* a_x, const float* a_y, const float* b_x, const float* b_y, float* out, int count) {
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 x = _mm_mul_ps(_mm_loadu_ps(a_x + i), _mm_loadu_ps(b_x + i));
+        __m128 y = _mm_mul_ps(_mm_loadu_ps(a_y + i), _mm_loadu_ps(b_y + i));
+        _mm_storeu_ps(out + i, _mm_add_ps(x, y));
+    }
+    hf_batch_kernels_scalar.dot(a_x + i, a_y + i, b_x + i, b_y + i, out + i, count - i);
+}
+
+static void hf_batch_sse2__sqr_distance(const float* x, const float* y, float* out, int count, HF_Vec2f point) {
+    __m128 point_x = _mm_set1_ps(point.x);
+    __m128 point_y = _mm_set1_ps(point.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 vec_x = _mm_sub_ps(_mm_loadu_ps(x + i), point_x);
+        __m128 vec_y = _mm_sub_ps(_mm_loadu_ps(y + i), point_y);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(vec_x, vec_x), _mm_mul_ps(vec_y, vec_y)));
+    }
+    hf_batch_kernels_scalar.sqr_distance(x + i, y + i, out + i, count - i, point);
+}
+
+static int hf_batch_sse2__circles_contain(const float* x, const float* y, const float* radius, int count, HF_Vec2f point) {
+    __m128 point_x = _mm_set1_ps(point.x);
+    __m128 point_y = _mm_set1_ps(point.y);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 vec_x = _mm_sub_ps(_mm_loadu_ps(x + i), point_x);
+        __m128 vec_y = _mm_sub_ps(_mm_loadu_ps(y + i), point_y);
+        __m128 sqr_distance = _mm_add_ps(_mm_mul_ps(vec_x, vec_x), _mm_mul_ps(vec_y, vec_y));
+        __m128 r = _mm_loadu_ps(radius + i);
+        int inside = _mm_movemask_ps(_mm_cmplt_ps(sqr_distance, _mm_mul_ps(r, r)));
+        for(int j = 0; inside; j++, inside >>= 1) {//lowest lane first, the same circle the scalar loop finds
+            if(inside & 1) {
+                return i + j;
+            }
+        }
+    }
+    int found = hf_batch_kernels_scalar.circles_contain(x + i, y + i, radius + i, count - i, point);
+    return found < 0 ? -1 : i + found;
+}
+
+static int hf_batch_sse2__lines_hit(HF_Line line, const float* start_x, const float* start_y, const float* end_x, const float* end_y, int count, int* hits) {
+    HF_Vec2f a_vec = hf_vec2f_subtract(line.end, line.start);
+    __m128 a_vec90_x = _mm_set1_ps(a_vec.y);
+    __m128 a_vec90_y = _mm_set1_ps(-a_vec.x);
+    __m128 line_start_x = _mm_set1_ps(line.start.x);
+    __m128 line_start_y = _mm_set1_ps(line.start.y);
+    __m128 line_end_x = _mm_set1_ps(line.end.x);
+    __m128 line_end_y = _mm_set1_ps(line.end.y);
+    __m128 sign = _mm_set1_ps(-0.f);
+    __m128 zero = _mm_setzero_ps();
+
+    int hit_count = 0;
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 s_x = _mm_loadu_ps(start_x + i);
+        __m128 s_y = _mm_loadu_ps(start_y + i);
+        __m128 e_x = _mm_loadu_ps(end_x + i);
+        __m128 e_y = _mm_loadu_ps(end_y + i);
+
+        __m128 b_start_side = _mm_add_ps(_mm_mul_ps(a_vec90_x, _mm_sub_ps(s_x, line_start_x)), _mm_mul_ps(a_vec90_y, _mm_sub_ps(s_y, line_start_y)));
+        __m128 b_end_side = _mm_add_ps(_mm_mul_ps(a_vec90_x, _mm_sub_ps(e_x, line_start_x)), _mm_mul_ps(a_vec90_y, _mm_sub_ps(e_y, line_start_y)));
+        __m128 b_vec90_x = _mm_sub_ps(e_y, s_y);
+        __m128 b_vec90_y = _mm_xor_ps(_mm_sub_ps(e_x, s_x), sign);
+        __m128 a_start_side = _mm_add_ps(_mm_mul_ps(b_vec90_x, _mm_sub_ps(line_start_x, s_x)), _mm_mul_ps(b_vec90_y, _mm_sub_ps(line_start_y, s_y)));
+        __m128 a_end_side = _mm_add_ps(_mm_mul_ps(b_vec90_x, _mm_sub_ps(line_end_x, s_x)), _mm_mul_ps(b_vec90_y, _mm_sub_ps(line_end_y, s_y)));
+
+        __m128 b_crosses = _mm_xor_ps(_mm_cmpgt_ps(b_start_side, zero), _mm_cmpgt_ps(b_end_side, zero));
+        __m128 a_crosses = _mm_xor_ps(_mm_cmpgt_ps(a_start_side, zero), _mm_cmpgt_ps(a_end_side, zero));
+        int crossed = _mm_movemask_ps(_mm_and_ps(b_crosses, a_crosses));
+        for(int j = 0; crossed; j++, crossed >>= 1) {
+            if(crossed & 1) {
+                hits[hit_count] = i + j;
+                hit_count++;
+            }
+        }
+    }
+
+    int tail_count = hf_batch_kernels_scalar.lines_hit(line, start_x + i, start_y + i, end_x + i, end_y + i, count - i, hits + hit_count);
+    for(int j = hit_count; j < hit_count + tail_count; j++) {
+        hits[j] += i;
+    }
+    return hit_count + tail_count;
+}
+
+static const HF_BatchKernels hf_batch_sse2__kernels = {
+    .translate = hf_batch_sse2__translate,
+    .translate_xy = hf_batch_sse2__translate_xy,
+    .rotate = hf_batch_sse2__rotate,
+    .dot = hf_batch_sse2__dot,
+    .sqr_distance = hf_batch_sse2__sqr_distance,
+    .circles_contain = hf_batch_sse2__circles_contain,
+    .lines_hit = hf_batch_sse2__lines_hit,
+};
+
+const HF_BatchKernels* const hf_batch_kernels_sse2 = &hf_batch_sse2__kernels;
+
+#else
+
+const HF_BatchKernels* const hf_batch_kernels_sse2 = NULL;
+
+#endif
@@ -1,52 +1,34 @@
 #include "../include/hf_intersection.h"
-#include <math.h>
 
-bool hf_intersection_lines(HF_Line a, HF_Line b, HF_Vec2f* hit_point) {
-    //complex line overlap algorithm:
-    //1. rotate lines so that one of them is axis aligned
-    //2. check if second line would intersect an infinite fisrt line
-    //3. check if would be contact point is really in range of the finite first line
+HF_API bool hf_intersection_lines(HF_Line a, HF_Line b, HF_Vec2f* hit_point) {
+    //the segments cross when the points of each one are on opposite sides of the other
+    //the side is the sign of a cross product, written as a dot with the vector rotated by 90 degrees
     HF_Vec2f a_vec = hf_vec2f_subtract(a.end, a.start);
-    {//use dot to check if a is between the points of b
-        HF_Vec2f a_vec90 = { a_vec.y, -a_vec.x };//a vector but rotated by 90 degrees
-
-        bool dot1 = hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.start, a.start)) > 0.f;
-        bool dot2 = hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.end, a.start)) > 0.f;
-
-        if(dot1 == dot2) {//it both dot products are the same signal, it means no intersection can occur
-            return false;
-        }
+    HF_Vec2f a_vec90 = { a_vec.y, -a_vec.x };
+    float b_start_side = hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.start, a.start));
+    float b_end_side = hf_vec2f_dot(a_vec90, hf_vec2f_subtract(b.end, a.start));
+    if((b_start_side > 0.f) == (b_end_side > 0.f)) {//same signal, b is all on one side of a
+        return false;
     }
 
     HF_Vec2f b_vec = hf_vec2f_subtract(b.end, b.start);
-    {//use dot to check if b is between the points of a
-        HF_Vec2f b_vec90 = { b_vec.y, -b_vec.x };//b vector but rotated by 90 degrees
-
-        bool dot1 = hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.start, b.start)) > 0.f;
-        bool dot2 = hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.end,   b.start)) > 0.f;
-
-        if(dot1 == dot2) {
-            return false;
-        }
+    HF_Vec2f b_vec90 = { b_vec.y, -b_vec.x };
+    float a_start_side = hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.start, b.start));
+    float a_end_side = hf_vec2f_dot(b_vec90, hf_vec2f_subtract(a.end, b.start));
+    if((a_start_side > 0.f) == (a_end_side > 0.f)) {
+        return false;
     }
 
     if(hit_point) {
-        float angle = hf_vec2f_angle(a_vec);
-        float rotation_sin = sinf(-angle);
-        float rotation_cos = cosf(-angle);
-        HF_Vec2f as_rot = hf_vec2f_rotate_cached(a.start, rotation_sin, rotation_cos);
-        HF_Vec2f bs_rot = hf_vec2f_rotate_cached(b.start, rotation_sin, rotation_cos);
-        HF_Vec2f bv_rot = hf_vec2f_rotate_cached(b_vec, rotation_sin, rotation_cos);
-
-        float by_amp = fabsf(bv_rot.y);
-        float lerp = by_amp > 0.f ? fabsf(as_rot.y - bs_rot.y) / by_amp : 0.5f;
-
+        //the sides are distances to a scaled by its length, so their ratio is how far along b the crossing is
+        //they have different signals here, so the denominator is never 0
+        float lerp = b_start_side / (b_start_side - b_end_side);
         *hit_point = hf_vec2f_add(b.start, hf_vec2f_multiply(b_vec, lerp));
     }
     return true;
 }
 
-bool hf_intersection_triangles(HF_Triangle a, HF_Triangle b, HF_Vec2f* hit_point) {
+HF_API bool hf_intersection_triangles(HF_Triangle a, HF_Triangle b, HF_Vec2f* hit_point) {
     HF_Line edges_a[3];
     HF_Line edges_b[3];
     hf_triangle_get_edges(a, edges_a);
@@ -86,7 +68,7 @@ bool hf_intersection_triangles(HF_Triangle a, HF_Triangle b, HF_Vec2f* hit_point
     return hit_count > 0;// TODO: better hit point detection
 }
 
-bool hf_intersection_circles(HF_Circle a, HF_Circle b, HF_Vec2f* hit_point) {
+HF_API bool hf_intersection_circles(HF_Circle a, HF_Circle b, HF_Vec2f* hit_point) {
     HF_Vec2f vec = hf_vec2f_subtract(a.position, b.position);
     bool retval = hf_vec2f_sqr_magnitude(vec) <= (a.radius + b.radius) * (a.radius + b.radius);
     if(hit_point) {
@@ -96,7 +78,7 @@ bool hf_intersection_circles(HF_Circle a, HF_Circle b, HF_Vec2f* hit_point) {
 }
 
 
-bool hf_intersection_line_triangle(HF_Line line, HF_Triangle triangle, HF_Vec2f* hit_point) {
+HF_API bool hf_intersection_line_triangle(HF_Line line, HF_Triangle triangle, HF_Vec2f* hit_point) {
     HF_Line triangle_edges[3];
     hf_triangle_get_edges(triangle, triangle_edges);
 
@@ -119,7 +101,7 @@ bool hf_intersection_line_triangle(HF_Line line, HF_Triangle triangle, HF_Vec2f*
 }
 
 
-bool hf_intersection_line_circle(HF_Line line, HF_Circle circle, HF_Vec2f* hit_point) {
+HF_API bool hf_intersection_line_circle(HF_Line line, HF_Circle circle, HF_Vec2f* hit_point) {
     HF_Vec2f closest_point = hf_line_closest_point(line, circle.position);
     HF_Vec2f vec = hf_vec2f_subtract(closest_point, circle.position);
 
@@ -130,7 +112,7 @@ bool hf_intersection_line_circle(HF_Line line, HF_Circle circle, HF_Vec2f* hit_p
 }
 
 
-bool hf_intersection_triangle_circle(HF_Triangle triangle, HF_Circle circle, HF_Vec2f* hit_point) {
+HF_API bool hf_intersection_triangle_circle(HF_Triangle triangle, HF_Circle circle, HF_Vec2f* hit_point) {
     HF_Line triangle_edges[3];
     hf_triangle_get_edges(triangle, triangle_edges);
 
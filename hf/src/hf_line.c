@@ -1,26 +1,14 @@
 #include "../include/hf_line.h"
-#include <math.h>
 
-HF_Vec2f hf_line_closest_point(HF_Line line, HF_Vec2f point) {
+HF_API HF_Vec2f hf_line_closest_point(HF_Line line, HF_Vec2f point) {
+    //project point on the line and clamp the projection to the segment
     HF_Vec2f line_vec = hf_vec2f_subtract(line.end, line.start);
-    float angle = hf_vec2f_angle(line_vec);
+    float length_sqr = hf_vec2f_sqr_magnitude(line_vec);
+    if(length_sqr <= 0.f) {
+        return line.start;
+    }
 
-    //rotate line and vector so they are aligned horizontally
-    float rotation_sin = sinf(-angle);
-    float rotation_cos = cosf(-angle);
-    HF_Line line_rot = {
-        hf_vec2f_rotate_cached(line.start, rotation_sin, rotation_cos),
-        hf_vec2f_rotate_cached(line.end, rotation_sin, rotation_cos),
-    };
-    HF_Vec2f point_rot = hf_vec2f_rotate(point, -angle);
-
-    float line_max_x = line_rot.start.x > line_rot.end.x ? line_rot.start.x : line_rot.end.x;
-    float line_min_x = line_rot.start.x <= line_rot.end.x ? line_rot.start.x : line_rot.end.x;
-    HF_Vec2f aligned_point = {
-        point_rot.x > line_max_x ?
-            line_max_x :
-            (point_rot.x < line_min_x ? line_min_x : point_rot.x),
-        line_rot.start.y,
-    };
-    return hf_vec2f_rotate_cached(aligned_point, -rotation_sin, rotation_cos);//return point rotated back to original space
+    float t = hf_vec2f_dot(hf_vec2f_subtract(point, line.start), line_vec) / length_sqr;
+    t = t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+    return hf_vec2f_add(line.start, hf_vec2f_multiply(line_vec, t));
 }
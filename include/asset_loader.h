@@ -0,0 +1,77 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_mixer.h"
+#include "SDL2/SDL_ttf.h"
+
+#include "audio.h"
+#include "pak.h"
+
+#define ASSET_LOADER_MAX_JOBS 32
+#define ASSET_LOADER_MAX_THREADS 4
+
+typedef enum AssetKind_s {
+    ASSET_KIND_Texture,//SDL_Texture*, the bmp is decoded on a worker and uploaded by asset_loader_poll
+    ASSET_KIND_KeyedTexture,//same with magenta as the color key
+    ASSET_KIND_Chunk,//Mix_Chunk*, loaded one at a time like every mixer asset
+    ASSET_KIND_Music,//Mix_Chunk* of the whole track, decoded once and kept in the cache folder after that
+    ASSET_KIND_Font,//TTF_Font*, opened one at a time, the data has to outlive the font
+} AssetKind;
+
+typedef enum AssetJobState_s {
+    ASSET_JOB_STATE_Queued,
+    ASSET_JOB_STATE_Decoding,
+    ASSET_JOB_STATE_Decoded,//waiting for asset_loader_poll to finish it on the main thread
+    ASSET_JOB_STATE_Done,
+    ASSET_JOB_STATE_Failed,
+} AssetJobState;
+
+typedef struct AssetJob_s {
+    AssetKind kind;
+    const char* path;//relative to the assets folder, same as the name in the archive
+    int font_size;
+    void** target;//written by asset_loader_poll once the asset is ready, left NULL on failure
+
+    SDL_atomic_t state;//AssetJobState
+    SDL_Surface* surface;//textures only, decoded but not uploaded yet
+    void* loaded;
+    Uint64 decode_ticks;
+    bool finished;//handed out or given up on, main thread only
+} AssetJob;
+
+//decodes files on a pool of SDL threads, only the texture uploads happen on the thread that polls
+typedef struct AssetLoader_s {
+    const Pak* pak;//files come from here when it's open
+    const char* root;//otherwise from loose files under this folder
+    const char* cache_dir;//decoded music goes here, NULL decodes it on every launch
+
+    AssetJob jobs[ASSET_LOADER_MAX_JOBS];
+    int job_count;
+    int finished_count;//Done or Failed, main thread only
+
+    SDL_atomic_t next_job;
+    SDL_atomic_t cancel;
+    SDL_Thread* threads[ASSET_LOADER_MAX_THREADS];
+    int thread_count;
+    SDL_mutex* font_mutex;//FreeType isn't safe to open faces from several threads
+    SDL_mutex* mixer_mutex;//SDL_mixer doesn't promise its decoders can start on several threads either
+
+    int texture_creations;//reset by whoever reads it
+} AssetLoader;
+
+void asset_loader_init(AssetLoader* loader, const Pak* pak, const char* root, const char* cache_dir);
+//view of the file in the archive, or the loose file when there is no archive
+SDL_RWops* asset_loader_open(AssetLoader* loader, const char* name);
+//target must stay valid until the job is finished, returns the job index to check with asset_loader_job_finished
+int asset_loader_add(AssetLoader* loader, AssetKind kind, const char* path, int font_size, void* target);
+void asset_loader_start(AssetLoader* loader);
+//uploads decoded textures and hands out finished assets, returns true once every job is finished
+bool asset_loader_poll(AssetLoader* loader, SDL_Renderer* renderer);
+bool asset_loader_job_finished(AssetLoader* loader, int job);
+//stops the workers, assets that were never handed out are freed
+void asset_loader_deinit(AssetLoader* loader);
+
+#endif//ASSET_LOADER_H
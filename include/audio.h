@@ -0,0 +1,86 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_mixer.h"
+
+#define AUDIO_FREQUENCY 48000
+#define AUDIO_DEFAULT_BUFFER_FRAMES 2048//~43 ms at 48 kHz
+#define AUDIO_LOW_LATENCY_BUFFER_FRAMES 256//~5 ms, only safe because nothing is decoded in the callback anymore
+#define AUDIO_CHANNELS 20
+#define AUDIO_MUSIC_CHANNEL 0//reserved, the music plays as a chunk on it
+#define AUDIO_SFX_GROUP 1//every other channel, the oldest one is stolen when they are all busy
+#define AUDIO_QUEUE_CAPACITY 64//power of two
+
+//decoded track cache, native endian since it never leaves the machine:
+//AudioCacheHeader then data_size bytes of samples in the device format
+#define AUDIO_CACHE_MAGIC 0x4D435054u//"TPCM"
+#define AUDIO_CACHE_VERSION 1
+
+typedef struct AudioCacheHeader_s {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 source_size;//the cache is stale when the compressed file changes
+    Uint32 source_crc;
+    Uint32 frequency;
+    Uint16 format;
+    Uint16 channels;
+    Uint32 data_size;
+} AudioCacheHeader;
+
+//a sound to start, pushed by the game loop and started by the mixer at the top of its next callback
+typedef struct AudioEvent_s {
+    Mix_Chunk* chunk;//must stay loaded until audio_close
+    int loops;
+} AudioEvent;
+
+//single producer, single consumer, the indices run free and wrap through the mask
+typedef struct AudioQueue_s {
+    AudioEvent events[AUDIO_QUEUE_CAPACITY];
+    SDL_atomic_t head;//next event the mixer reads, written by the mixer only
+    SDL_atomic_t tail;//next slot the game loop writes, written by the game loop only
+    SDL_atomic_t dropped;//pushes that found the queue full
+} AudioQueue;
+
+typedef struct AudioStats_s {
+    int callbacks;
+    int underruns;//callbacks that came more than a buffer after the device needed them
+    int steals;//sounds that cut off the oldest one because every channel was busy
+    int dropped;
+    Uint64 callback_ticks;//summed over the callbacks
+    Uint64 max_callback_ticks;
+} AudioStats;
+
+typedef struct Audio_s {
+    bool open;
+    int frequency;//what the device was opened with, chunks are converted to it when they load
+    Uint16 format;
+    int channels;
+    int buffer_frames;
+    Uint64 buffer_ticks;//how long one buffer plays, in performance counter ticks
+
+    //audio thread only
+    Uint64 callback_start;
+    Uint64 anchor;//start of a callback that came on time, later ones are due a buffer apart from it
+    Uint64 buffers_since_anchor;
+
+    AudioQueue queue;
+
+    SDL_SpinLock stats_lock;
+    AudioStats stats;//since the last audio_take_stats
+} Audio;
+
+//opens the mixer with buffer_frames per callback and hooks the callback timing, audio must not move while open
+bool audio_open(Audio* audio, int buffer_frames);
+void audio_close(Audio* audio);
+AudioStats audio_take_stats(Audio* audio);
+//never blocks and never touches the mixer lock, false when the queue is full and the sound is dropped
+bool audio_play(Audio* audio, Mix_Chunk* chunk, int loops);
+
+//a whole track decoded to the device format, read from cache_path when an earlier run already decoded it, closes rw
+//cache_path may be NULL, the track is decoded every time then
+Mix_Chunk* audio_load_track(SDL_RWops* rw, const char* cache_path);
+
+#endif//AUDIO_H
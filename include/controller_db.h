@@ -0,0 +1,31 @@
+#ifndef CONTROLLER_DB_H
+#define CONTROLLER_DB_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "controller_db_format.h"
+
+typedef struct ControllerDb_s {
+    void* data;
+    const ControllerDbEntry* entries;
+    Uint32 entry_count;
+    const char* strings;
+    Uint32 platform;//ControllerDbPlatform we are running on
+} ControllerDb;
+
+//reads and validates the whole table, closes rw, false leaves an empty db that finds nothing
+bool controller_db_load(ControllerDb* db, SDL_RWops* rw);
+void controller_db_free(ControllerDb* db);
+
+//mapping for guid on this platform, NULL when the db doesn't know the device
+//like SDL, a guid that isn't in the db is tried again without its crc and version
+const char* controller_db_find(const ControllerDb* db, SDL_JoystickGUID guid);
+//registers the mappings that aren't tied to one device, the "xinput" line, stored with a zero guid
+bool controller_db_add_defaults(const ControllerDb* db);
+//registers the mapping of a device seen in SDL_JOYDEVICEADDED, returns false when there is none
+bool controller_db_add_device(const ControllerDb* db, int device_index);
+//registers every mapping for this platform, the same set SDL_GameControllerAddMappingsFromRW would, returns how many
+int controller_db_add_all(const ControllerDb* db);
+
+#endif//CONTROLLER_DB_H
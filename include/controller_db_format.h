@@ -0,0 +1,39 @@
+#ifndef CONTROLLER_DB_FORMAT_H
+#define CONTROLLER_DB_FORMAT_H
+
+#include <stdint.h>
+
+//gamecontrollerdb.txt baked by tools/controller_db_pack, little endian:
+//ControllerDbHeader, entry_count ControllerDbEntry sorted by guid then platform, then the zero terminated mappings
+//plain C so the packer can write it without SDL
+#define CONTROLLER_DB_MAGIC 0x42444754u//"TGDB"
+#define CONTROLLER_DB_VERSION 1
+#define CONTROLLER_DB_GUID_SIZE 16
+
+//platform names as SDL_GetPlatform reports them, indexed by ControllerDbPlatform
+#define CONTROLLER_DB_PLATFORM_NAMES { "", "Windows", "Mac OS X", "Linux", "iOS", "Android" }
+
+typedef enum ControllerDbPlatform_s {
+    CONTROLLER_DB_PLATFORM_Any,//the line had no platform field
+    CONTROLLER_DB_PLATFORM_Windows,
+    CONTROLLER_DB_PLATFORM_MacOSX,
+    CONTROLLER_DB_PLATFORM_Linux,
+    CONTROLLER_DB_PLATFORM_iOS,
+    CONTROLLER_DB_PLATFORM_Android,
+    CONTROLLER_DB_PLATFORM_Count,
+} ControllerDbPlatform;
+
+typedef struct ControllerDbHeader_s {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t strings_size;
+} ControllerDbHeader;
+
+typedef struct ControllerDbEntry_s {
+    uint8_t guid[CONTROLLER_DB_GUID_SIZE];
+    uint32_t platform;//ControllerDbPlatform
+    uint32_t mapping;//offset into the strings, the line without its platform field, ready for SDL_GameControllerAddMapping
+} ControllerDbEntry;
+
+#endif//CONTROLLER_DB_FORMAT_H
@@ -0,0 +1,65 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdbool.h>
+
+#include "rng.h"
+#include "vine.h"
+#include "world.h"
+
+#define GAME_WORLD_W 960
+#define GAME_WORLD_H 540
+
+#define GAME_MAX_SPEED 5.f
+#define GAME_MAX_SOUNDS 16//per drain, extra sounds are dropped
+
+typedef enum GameState_s {
+    GAME_STATE_Start,
+    GAME_STATE_Play,
+    GAME_STATE_Lost,
+} GameState;
+
+typedef struct GameInput_s {
+    VineInput vine_input;
+    bool ok;
+} GameInput;
+
+typedef enum GameSound_s {
+    GAME_SOUND_Leaves,
+} GameSound;
+
+typedef struct GameSoundEvent_s {
+    GameSound sound;
+    int variant;
+} GameSoundEvent;
+
+//the whole simulation, nothing here needs a window, a renderer or an audio device
+typedef struct GameData_s {
+    Uint64 seed;
+    Rng world_rng;//only world_generate draws from it, so the n-th round has the same layout whatever was played before
+    Rng rng;//everything else the simulation randomizes
+    Vine vine;
+    World world;
+    float counter;
+    float vine_speed;
+    bool vine_go;
+    int score;
+    int best_score;
+    GameState game_state;
+    bool tuto_flash;
+    float tuto_timer;
+
+    //emitted by game_data_update, played and cleared by whoever owns the audio
+    GameSoundEvent sounds[GAME_MAX_SOUNDS];
+    int sound_count;
+} GameData;
+
+void game_data_init(GameData* game_data, Uint64 seed);
+void game_data_deinit(GameData* game_data);
+void game_data_reset(GameData* game_data);
+void game_data_update(GameData* game_data, GameInput input, float delta);
+//FNV-1a over everything the simulation carries from tick to tick, equal hashes mean a replay played out the same
+//left out: the vine grid, collision cache, candidates and generation (bookkeeping around the points) and the sounds (drained by the audio owner)
+Uint64 game_data_hash(GameData* game_data);
+
+#endif//GAME_H
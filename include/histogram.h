@@ -0,0 +1,24 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "SDL2/SDL.h"
+
+//log-linear buckets like HdrHistogram: exact below 2 * HISTOGRAM_SUB_BUCKETS, then
+//HISTOGRAM_SUB_BUCKETS linear buckets per power of two, so every value is kept within 1 / HISTOGRAM_SUB_BUCKETS (3.1%)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((32 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)//covers every Uint32
+
+//values are microseconds for the frame times, but any Uint32 works
+typedef struct Histogram_s {
+    Uint32 counts[HISTOGRAM_BUCKETS];
+    Uint64 total;
+    Uint32 max;//exact, the buckets only keep it within the precision
+} Histogram;
+
+void histogram_reset(Histogram* histogram);
+void histogram_record(Histogram* histogram, Uint32 value);
+//highest value of the bucket holding the percentile, 0 to 100, never above the max
+Uint32 histogram_percentile(const Histogram* histogram, double percentile);
+
+#endif//HISTOGRAM_H
@@ -0,0 +1,32 @@
+#ifndef PAK_H
+#define PAK_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "pak_format.h"
+
+//a read only mapping of the whole archive, files are handed out as views into it
+typedef struct Pak_s {
+    const Uint8* data;
+    size_t size;
+    const PakEntry* entries;
+    Uint32 entry_count;
+
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+} Pak;
+
+bool pak_open(Pak* pak, const char* path);
+void pak_close(Pak* pak);
+
+//pointer into the mapping, valid until pak_close, NULL when the archive doesn't have it
+const void* pak_find(const Pak* pak, const char* name, size_t* size);
+//SDL_RWFromConstMem over pak_find, no copy
+SDL_RWops* pak_open_rw(const Pak* pak, const char* name);
+
+#endif//PAK_H
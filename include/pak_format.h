@@ -0,0 +1,26 @@
+#ifndef PAK_FORMAT_H
+#define PAK_FORMAT_H
+
+#include <stdint.h>
+
+//archive layout, little endian: PakHeader, entry_count PakEntry sorted by name, then the file data
+//plain C so tools/asset_pack can write it without SDL
+#define PAK_MAGIC 0x4B415054u//"TPAK"
+#define PAK_VERSION 1
+#define PAK_NAME_SIZE 56
+#define PAK_ALIGNMENT 16//of every file's data
+
+typedef struct PakHeader_s {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+} PakHeader;
+
+typedef struct PakEntry_s {
+    char name[PAK_NAME_SIZE];//path relative to the assets folder, '/' separated, zero terminated
+    uint32_t offset;//from the start of the archive
+    uint32_t size;
+} PakEntry;
+
+#endif//PAK_FORMAT_H
@@ -0,0 +1,97 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "text.h"
+
+#define PROFILER_CAPACITY 4096//samples, power of two, a bit over 5 seconds of frames at 60 Hz
+#define PROFILER_OVERLAY_KEY SDLK_F3
+#define PROFILER_TRACE_KEY SDLK_F4
+#define PROFILER_DEFAULT_TRACE_PATH "trace.json"
+
+//release builds only keep the scopes with TREPADEIRA_PROFILER
+#if !defined(NDEBUG) || defined(TREPADEIRA_PROFILER)
+#define PROFILER_ENABLED
+#endif
+
+typedef enum ProfilerPhase_s {
+    PROFILER_PHASE_Frame,//the whole main loop iteration, the other phases are inside it
+    PROFILER_PHASE_Events,
+    PROFILER_PHASE_Update,//every game_data_update of the frame
+    PROFILER_PHASE_Tiles,//world_set_tiles, bakes the backgrounds when the tiles changed
+    PROFILER_PHASE_WorldClear,
+    PROFILER_PHASE_VineShadow,//vine_draw of the shadow pass
+    PROFILER_PHASE_Vine,//vine_draw of the vine itself
+    PROFILER_PHASE_Compose,
+    PROFILER_PHASE_Hud,
+    PROFILER_PHASE_Present,
+    PROFILER_PHASE_Count,
+} ProfilerPhase;
+
+#define PROFILER_PHASE_NAMES { "frame", "events", "update", "tiles", "world_clear", "vine_shadow", "vine", "compose", "hud", "present" }
+
+typedef struct ProfilerSample_s {
+    Uint64 start;//performance counter
+    Uint64 end;
+    int frame;
+    Uint8 phase;
+    Uint8 depth;//scopes open around it
+} ProfilerSample;
+
+//single writer (the main loop), any thread may read, the oldest samples are overwritten
+typedef struct Profiler_s {
+    ProfilerSample samples[PROFILER_CAPACITY];
+    SDL_atomic_t written;//free running, samples below it are complete
+
+    //main loop only
+    int frame;
+    int depth;
+    int aggregated;//samples already added to the window
+
+    //per frame milliseconds of the last whole second, what the overlay shows
+    Uint64 window_start;
+    int window_frames;
+    Uint64 frame_ticks[PROFILER_PHASE_Count];
+    Uint64 window_ticks[PROFILER_PHASE_Count];
+    Uint64 window_max_ticks[PROFILER_PHASE_Count];
+    double average_ms[PROFILER_PHASE_Count];
+    double max_ms[PROFILER_PHASE_Count];
+
+    bool overlay;
+} Profiler;
+
+typedef struct ProfilerScope_s {
+    Profiler* profiler;
+    ProfilerPhase phase;
+    Uint64 start;
+    bool done;
+} ProfilerScope;
+
+//times the statement or block after it, which must not break or return out of the scope
+#ifdef PROFILER_ENABLED
+#define PROFILER_SCOPE(profiler, phase) \
+    for(ProfilerScope profiler__scope = profiler_begin((profiler), (phase)); !profiler__scope.done; profiler_end(&profiler__scope))
+#else
+//a loop that runs once like the enabled form, an if would take an else that follows the block
+#define PROFILER_SCOPE(profiler, phase) \
+    for(int profiler__once = ((void)(profiler), (void)(phase), 0); !profiler__once; profiler__once = 1)
+#endif
+
+void profiler_init(Profiler* profiler);
+ProfilerScope profiler_begin(Profiler* profiler, ProfilerPhase phase);
+void profiler_end(ProfilerScope* scope);
+//adds the frame's samples to the overlay numbers, once per main loop iteration
+void profiler_end_frame(Profiler* profiler);
+
+//the newest count samples or less, oldest first, returns how many were copied
+int profiler_copy(Profiler* profiler, ProfilerSample* samples, int count);
+//every sample still in the ring as Chrome trace JSON (chrome://tracing, Perfetto)
+bool profiler_write_trace(Profiler* profiler, const char* path);
+//ms per phase of the last frame_count finished frames as CSV, one row per frame
+bool profiler_write_frames(Profiler* profiler, const char* path, int frame_count);
+
+void profiler_draw_overlay(Profiler* profiler, SDL_Renderer* renderer, TextAtlas* atlas, int x, int y);
+
+#endif//PROFILER_H
@@ -0,0 +1,59 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "game.h"
+
+//recorded inputs, little endian: ReplayHeader, then run_count ReplayRun
+#define REPLAY_MAGIC 0x4c505254u//"TRPL"
+#define REPLAY_VERSION 1
+
+typedef struct ReplayHeader_s {
+    Uint32 magic;
+    Uint32 version;
+    Uint64 seed;//given to game_data_init
+    Uint32 tick_rate;//for playing back in real time
+    Uint32 tick_delta;//bits of the float given to game_data_update, the rate alone rounds differently per platform
+    Uint32 tick_count;
+    Uint32 run_count;
+    Uint64 final_hash;//game_data_hash after the last tick
+} ReplayHeader;
+
+//count ticks in a row with the same input, held turns take one run instead of one entry per tick
+typedef struct ReplayRun_s {
+    Sint8 turn;//keyboard and controller only give whole steps
+    Uint8 ok;
+    Uint16 count;
+} ReplayRun;
+
+typedef struct Replay_s {
+    Uint64 seed;
+    int tick_rate;
+    float tick_delta;
+    Uint32 tick_count;
+    Uint64 final_hash;
+
+    ReplayRun* runs;
+    Uint32 run_count;
+    Uint32 run_capacity;
+
+    //playback position
+    Uint32 cursor;//run
+    Uint32 cursor_tick;//inside the run
+} Replay;
+
+void replay_init(Replay* replay, Uint64 seed, int tick_rate, float tick_delta);
+void replay_free(Replay* replay);
+
+//appends the input of one tick, false when out of memory
+bool replay_record(Replay* replay, GameInput input);
+//input of the next tick, false past the last one
+bool replay_next(Replay* replay, GameInput* input);
+
+bool replay_save(const Replay* replay, const char* path);
+//reads and validates the whole file, false leaves an empty replay
+bool replay_load(Replay* replay, const char* path);
+
+#endif//REPLAY_H
@@ -0,0 +1,19 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "SDL2/SDL.h"
+
+//xoshiro128**, small and fast, integer only so a seed gives the same numbers on every platform and libc
+typedef struct Rng_s {
+    Uint32 state[4];
+} Rng;
+
+//any seed works, it is spread over the state with splitmix64
+void rng_seed(Rng* rng, Uint64 seed);
+Uint32 rng_next(Rng* rng);
+//0 to bound - 1 without the modulo bias, bound must be above 0
+int rng_range(Rng* rng, int bound);
+//0 to 1 (excluded), 24 bits, exact in a float
+float rng_float(Rng* rng);
+
+#endif//RNG_H
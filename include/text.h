@@ -0,0 +1,38 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <stdbool.h>
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_ttf.h"
+
+#define TEXT_FIRST_GLYPH ' '
+#define TEXT_LAST_GLYPH '~'
+#define TEXT_GLYPH_COUNT (TEXT_LAST_GLYPH - TEXT_FIRST_GLYPH + 1)
+#define TEXT_ATLAS_W 512
+#define TEXT_MAX_QUADS 64//longer strings are cut
+
+typedef struct TextGlyph_s {
+    SDL_Rect rect;//where the glyph is in the atlas, one line tall
+    int advance;
+} TextGlyph;
+
+//printable ascii of one font rendered once into a texture, strings are drawn as quads out of it
+typedef struct TextAtlas_s {
+    SDL_Texture* texture;
+    int texture_w;
+    int texture_h;
+    int line_height;
+    TextGlyph glyphs[TEXT_GLYPH_COUNT];
+} TextAtlas;
+
+bool text_atlas_init(TextAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font);
+void text_atlas_deinit(TextAtlas* atlas);
+
+int text_width(TextAtlas* atlas, const char* text);
+//one SDL_RenderGeometry call, no allocation and no texture work
+void text_draw(TextAtlas* atlas, SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+//same with the right edge at x, for columns of numbers
+void text_draw_right(TextAtlas* atlas, SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+
+#endif//TEXT_H
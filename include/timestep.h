@@ -0,0 +1,26 @@
+#ifndef TIMESTEP_H
+#define TIMESTEP_H
+
+#include "SDL2/SDL.h"
+
+#define TIMESTEP_DEFAULT_TICK_RATE 120
+#define TIMESTEP_DEFAULT_MAX_TICKS 8//per frame, time past this is dropped instead of caught up
+
+//fixed step accumulator, real time goes in and a whole number of simulation ticks comes out
+typedef struct Timestep_s {
+    Uint64 tick_length;//performance counter ticks per simulation tick
+    Uint64 accumulator;
+    Uint64 previous_counter;
+    int max_ticks;
+    float tick_delta;//seconds per simulation tick, the delta given to the update
+} Timestep;
+
+void timestep_init(Timestep* timestep, int tick_rate, int max_ticks);
+//reads the performance counter and returns how many ticks to simulate this frame
+int timestep_begin_frame(Timestep* timestep);
+//same as timestep_begin_frame with the elapsed time given, in performance counter ticks
+int timestep_advance(Timestep* timestep, Uint64 elapsed);
+//how far into the next tick the accumulated time is, 0 to 1, for interpolating what is drawn
+float timestep_alpha(Timestep* timestep);
+
+#endif//TIMESTEP_H
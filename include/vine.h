@@ -4,28 +4,125 @@
 #include <stdbool.h>
 
 #include "hf_vec.h"
+#include "hf_line.h"
 #include "SDL2/SDL.h"
 
+#ifndef VINE_MAX_POINTS//endurance builds override this, e.g. -DVINE_MAX_POINTS=100000
 #define VINE_MAX_POINTS 1000
+#endif
 #define VINE_EXPAND_DISTANCE 15.f
 
+//smallest power of two that is >= x, evaluated at compile time (x must fit in 32 bits)
+#define VINE__SPREAD1(x) ((x) | ((x) >> 1))
+#define VINE__SPREAD2(x) (VINE__SPREAD1(x) | (VINE__SPREAD1(x) >> 2))
+#define VINE__SPREAD4(x) (VINE__SPREAD2(x) | (VINE__SPREAD2(x) >> 4))
+#define VINE__SPREAD8(x) (VINE__SPREAD4(x) | (VINE__SPREAD4(x) >> 8))
+#define VINE__SPREAD16(x) (VINE__SPREAD8(x) | (VINE__SPREAD8(x) >> 16))
+#define VINE__CEIL_POW2(x) (VINE__SPREAD16((x) - 1) + 1)
+
+//points live in a power of two ring buffer, so dropping the oldest point is just a head increment
+#define VINE_POINT_CAPACITY VINE__CEIL_POW2(VINE_MAX_POINTS + 1)
+#define VINE_POINT_MASK (VINE_POINT_CAPACITY - 1)
+
+//cells are a bit larger than a line, so each line touches at most 2x2 cells
+#define VINE_GRID_CELL_SIZE (VINE_EXPAND_DISTANCE + 1.f)
+#define VINE_GRID_CELLS_PER_LINE 4
+#define VINE_GRID_BUCKET_COUNT (VINE_POINT_CAPACITY * 2)
+
+//one node per cell a line touches, indices are stored + 1 so a zeroed grid is empty
+typedef struct VineGridNode_s {
+    unsigned int line;//free running index of the line's end point
+    int bucket;//bucket index + 1, 0 when the node is unused
+    int prev;
+    int next;
+} VineGridNode;
+
+//spatial hash of the vine lines, node slots follow the same ring order as the points
+typedef struct VineGrid_s {
+    int buckets[VINE_GRID_BUCKET_COUNT];
+    VineGridNode nodes[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+} VineGrid;
+
+//result of the last front line collision test, only recomputed after the front line moves
+typedef struct VineCollision_s {
+    bool valid;
+    bool hit;
+    HF_Vec2f hit_point;
+} VineCollision;
+
+//candidate lines of the front line, gathered as structure of arrays for hf_batch_lines_hit
+typedef struct VineCandidates_s {
+    float start_x[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    float start_y[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    float end_x[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    float end_y[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    unsigned int lines[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    int hits[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+} VineCandidates;
+
 typedef struct Vine_s {
     HF_Vec2f position;
     float angle;
-    HF_Vec2f points[VINE_MAX_POINTS];
-    int point_count;
+    float previous_angle;//before the last vine_process_input
+    HF_Vec2f points[VINE_POINT_CAPACITY];
+    unsigned int head;//free running index of the oldest point
+    unsigned int tail;//free running index one past the newest point
+    unsigned int generation;//bumped by vine_reset, a VineRender built from the old points starts over
+    VineGrid grid;//line i goes from point i - 1 to point i
+    VineCollision collision;
+    VineCandidates candidates;//scratch of vine_collision_self, here so every vine can be tested on its own
+    int collision_tests;//how many times the collision was actually computed, reset by whoever reads it
 } Vine;
 
+//regions whose pixels changed since they were last taken by vine_take_damage
+#define VINE_MAX_DAMAGE_RECTS 4
+typedef struct VineDamage_s {
+    bool all;//set when the vine was reset, everything must be redrawn
+    SDL_Rect rects[VINE_MAX_DAMAGE_RECTS];
+    int rect_count;
+    SDL_Rect tip;//bounds of the moving tip when damage was last taken
+} VineDamage;
+
+//what drawing a vine keeps between frames, every vine_draw and vine_take_damage first catches up with the vine
+typedef struct VineRender_s {
+    unsigned int generation;//of the vine the mesh was built from
+    unsigned int head;//lines up to this one are gone from the mesh
+    unsigned int tail;//lines before this one have their quad in the mesh
+    float tip_angle;//what the moving tip is drawn with, see vine_interpolate_tip
+    SDL_FPoint mesh[VINE_POINT_CAPACITY * 4];//sprite corners of line i at slot i, the slot after the newest line is the moving tip
+    VineDamage damage;
+} VineRender;
+
 typedef struct VineInput_s {
     float turn;
 } VineInput;
 
-void vine_reset(Vine* vine);
+//walks the points of a vine from oldest to newest
+typedef struct VineIterator_s {
+    Vine* vine;
+    unsigned int cursor;//free running index of the next point to be returned
+} VineIterator;
+
+void vine_reset(Vine* vine, HF_Vec2f position, float angle);
+int vine_point_count(Vine* vine);
 HF_Vec2f vine_next_point(Vine* vine);
-void vine_draw(Vine* vine, SDL_Renderer* renderer, SDL_Texture* texture, int offset_y, HF_Vec2f offset);
+void vine_draw(Vine* vine, VineRender* render, SDL_Renderer* renderer, SDL_Texture* texture, int offset_y, HF_Vec2f offset);
+//draws every sprite that reaches region, in the same order as vine_draw, the caller clips to region
+void vine_draw_region(Vine* vine, VineRender* render, SDL_Renderer* renderer, SDL_Texture* texture, int offset_y, HF_Vec2f offset, SDL_Rect region);
+//fills rects with what changed since the last call and returns how many, -1 when everything changed
+int vine_take_damage(Vine* vine, VineRender* render, SDL_Rect* rects);
 void vine_process_input(Vine* vine, VineInput input, float turn_multiplier, float delta);
+//for ticks that don't call vine_process_input, the tip stops turning instead of repeating the last turn
+void vine_hold(Vine* vine);
+//draws the tip alpha of the way from the angle before the last vine_process_input to the current one
+void vine_interpolate_tip(Vine* vine, VineRender* render, float alpha);
 void vine_expand(Vine* vine);
 
+VineIterator vine_iterator(Vine* vine);
+bool vine_iterator_next(VineIterator* iterator, HF_Vec2f* point);
+bool vine_iterator_next_line(VineIterator* iterator, HF_Line* line);
+
+//cached until vine_expand or vine_process_input moves the front line
 bool vine_collision_self(Vine* vine, HF_Vec2f* hit_point);
 
 #endif//VINE_H
@@ -5,6 +5,7 @@
 
 #include "SDL2/SDL.h"
 #include "hf_circle.h"
+#include "rng.h"
 
 #define WORLD_NUM_CLUSTERS 6
 #define WORLD_MIN_SIZE_CLUSTER 5
@@ -13,6 +14,44 @@
 #define WORLD_MIN_SIZE_HOLE 20
 #define WORLD_MAX_SIZE_HOLE 50
 
+#define WORLD_MAX_DIRTY_RECTS 8
+
+#define WORLD_BUBBLE_GRID_CELL_SIZE 16.f
+#define WORLD_BUBBLE_GRID_MAX_CELLS (1 << 20)//the cell size grows past this
+
+typedef enum WorldBubbleCell_s {
+    WORLD_BUBBLE_CELL_Empty,//no bubble touches the cell
+    WORLD_BUBBLE_CELL_Full,//the cell is inside some bubble
+    WORLD_BUBBLE_CELL_Boundary,//bubble edges cross the cell, its circles have to be tested
+} WorldBubbleCell;
+
+//coarse grid over the union of the bubble bounds, point queries are one lookup outside the boundary cells
+//boundary cells list the circles crossing them, compressed rows: cell i owns circles [starts[i]..starts[i + 1])
+//the circles are structure of arrays so a cell's list goes straight to hf_batch_circles_contain
+typedef struct WorldBubbleGrid_s {
+    float origin_x;
+    float origin_y;
+    float cell_size;
+    float inv_cell_size;
+    int columns;
+    int rows;
+
+    Uint8* cells;//WorldBubbleCell per cell
+    int* starts;
+    float* circle_x;
+    float* circle_y;
+    float* circle_radius;
+
+    //allocated sizes, buffers are reused between builds
+    int cell_capacity;
+    int circle_capacity;
+} WorldBubbleGrid;
+
+typedef enum WorldComposeMode_s {
+    WORLD_COMPOSE_MODE_Layered,//ground and sky masked separately with MOD, then added together
+    WORLD_COMPOSE_MODE_SinglePass,//one mask in the destination alpha, needs custom blend modes
+} WorldComposeMode;
+
 typedef struct World_s {
     int w;
     int h;
@@ -26,23 +65,63 @@ typedef struct World_s {
     SDL_Texture* mask_ground;
     SDL_Texture* mask_sky;
 
+    SDL_Texture* mask_all;//alpha 255 on ground, 0 in bubbles, single pass only
+
     SDL_Texture* composed_ground;
     SDL_Texture* composed_sky;
 
     SDL_Texture* composed_all;
 
+    //mask_ground/sky and composed_ground/sky are only allocated for the layered mode
+    WorldComposeMode compose_mode;
+    Uint64 compose_ticks;//time spent in world_compose_texture, reset by whoever reads it
+    int texture_creations;//same
+
+    SDL_Texture* tile_ground;
+    SDL_Texture* tile_sky;
+
+    //bg_* and mask_* only change with the tiles or the bubbles, they are redrawn when dirty
+    bool background_dirty;
+    bool masks_dirty;
+
+    //fg_* keeps its contents between frames, false when it has to be redrawn whole
+    bool foreground_valid;
+
+    //regions of composed_* that are out of date, the only ones world_compose_texture redoes
+    SDL_Rect dirty_rects[WORLD_MAX_DIRTY_RECTS];
+    int dirty_rect_count;
+
+    //bubble coverage, w * h bytes, 255 inside a bubble, source of every mask texture
+    Uint8* coverage;
+    bool mask_antialias;//takes effect the next time the masks are drawn
+
     HF_Circle bubbles[WORLD_MAX_SIZE_CLUSTER * WORLD_NUM_CLUSTERS];
     int bubble_count;
+    WorldBubbleGrid bubble_grid;//built by world_generate
 } World;
 
-void world_init(World* world, SDL_Renderer* renderer, int w, int h);
+void world_init(World* world, int w, int h);
+void world_init_render(World* world, SDL_Renderer* renderer);
 void world_deinit(World* world);
 
-void world_generate(World* world, SDL_Renderer* renderer);
+bool world_set_compose_mode(World* world, SDL_Renderer* renderer, WorldComposeMode mode);
+size_t world_texture_memory(World* world);
+
+//draws every bubble from rng, the same state gives the same layout everywhere
+void world_generate(World* world, Rng* rng);
+
+void world_set_tiles(World* world, SDL_Renderer* renderer, SDL_Texture* tile_ground, SDL_Texture* tile_sky);
+void world_invalidate(World* world);
 
 void world_clear(World* world, SDL_Renderer* renderer);
+void world_clear_region(World* world, SDL_Renderer* renderer, SDL_Rect rect);
+void world_mark_dirty(World* world, SDL_Rect rect);
 void world_compose_texture(World* world, SDL_Renderer* renderer);
 
+void world_bubble_grid_build(WorldBubbleGrid* grid, const HF_Circle* bubbles, int bubble_count, float cell_size);
+void world_bubble_grid_free(WorldBubbleGrid* grid);
+bool world_bubble_grid_contains(const WorldBubbleGrid* grid, HF_Vec2f point);
+
 bool world_point_is_in_bubble(World* world, HF_Vec2f point);
 bool world_point_is_off_world(World* world, HF_Vec2f point);
 
@@ -0,0 +1,215 @@
+#include "asset_loader.h"
+
+void asset_loader_init(AssetLoader* loader, const Pak* pak, const char* root, const char* cache_dir) {
+    loader->pak = pak;
+    loader->root = root;
+    loader->cache_dir = cache_dir;
+    loader->job_count = 0;
+    loader->finished_count = 0;
+    SDL_AtomicSet(&loader->next_job, 0);
+    SDL_AtomicSet(&loader->cancel, 0);
+    loader->thread_count = 0;
+    loader->font_mutex = SDL_CreateMutex();
+    loader->mixer_mutex = SDL_CreateMutex();
+    loader->texture_creations = 0;
+}
+
+int asset_loader_add(AssetLoader* loader, AssetKind kind, const char* path, int font_size, void* target) {
+    if(loader->job_count >= ASSET_LOADER_MAX_JOBS) {
+        return -1;
+    }
+
+    AssetJob* job = &loader->jobs[loader->job_count];
+    job->kind = kind;
+    job->path = path;
+    job->font_size = font_size;
+    job->target = (void**)target;
+    job->surface = NULL;
+    job->loaded = NULL;
+    job->decode_ticks = 0;
+    job->finished = false;
+    SDL_AtomicSet(&job->state, ASSET_JOB_STATE_Queued);
+    *job->target = NULL;
+
+    loader->job_count++;
+    return loader->job_count - 1;
+}
+
+SDL_RWops* asset_loader_open(AssetLoader* loader, const char* name) {
+    if(loader->pak && loader->pak->data) {
+        return pak_open_rw(loader->pak, name);
+    }
+
+    char path[256];
+    SDL_snprintf(path, sizeof(path), "%s%s", loader->root, name);
+    return SDL_RWFromFile(path, "rb");
+}
+
+static void asset_loader__decode(AssetLoader* loader, AssetJob* job) {
+    SDL_RWops* rw = asset_loader_open(loader, job->path);
+    if(!rw) {
+        return;
+    }
+
+    //every loader below frees rw
+    switch (job->kind) {
+    case ASSET_KIND_Texture:
+    case ASSET_KIND_KeyedTexture:
+        job->surface = SDL_LoadBMP_RW(rw, 1);
+        if(job->surface && job->kind == ASSET_KIND_KeyedTexture) {
+            SDL_SetColorKey(job->surface, SDL_TRUE, SDL_MapRGB(job->surface->format, 255, 0, 255));
+        }
+        break;
+    case ASSET_KIND_Chunk:
+        SDL_LockMutex(loader->mixer_mutex);
+        job->loaded = Mix_LoadWAV_RW(rw, 1);
+        SDL_UnlockMutex(loader->mixer_mutex);
+        break;
+    case ASSET_KIND_Music: {
+        //one cache file per track, named after its path
+        char cache_path[512];
+        if(loader->cache_dir) {
+            SDL_snprintf(cache_path, sizeof(cache_path), "%s%s.pcm", loader->cache_dir, job->path);
+            for(char* c = cache_path + SDL_strlen(loader->cache_dir); *c; c++) {
+                *c = *c == '/' ? '_' : *c;
+            }
+        }
+        SDL_LockMutex(loader->mixer_mutex);
+        job->loaded = audio_load_track(rw, loader->cache_dir ? cache_path : NULL);
+        SDL_UnlockMutex(loader->mixer_mutex);
+        break;
+    }
+    case ASSET_KIND_Font:
+        SDL_LockMutex(loader->font_mutex);
+        job->loaded = TTF_OpenFontRW(rw, 1, job->font_size);
+        SDL_UnlockMutex(loader->font_mutex);
+        break;
+    default:
+        SDL_RWclose(rw);
+        break;
+    }
+}
+
+static int asset_loader__worker(void* data) {
+    AssetLoader* loader = data;
+    for(;;) {
+        if(SDL_AtomicGet(&loader->cancel)) {
+            break;
+        }
+        int index = SDL_AtomicAdd(&loader->next_job, 1);
+        if(index >= loader->job_count) {
+            break;
+        }
+
+        AssetJob* job = &loader->jobs[index];
+        SDL_AtomicSet(&job->state, ASSET_JOB_STATE_Decoding);
+        Uint64 start = SDL_GetPerformanceCounter();
+        asset_loader__decode(loader, job);
+        job->decode_ticks = SDL_GetPerformanceCounter() - start;
+
+        bool ok = job->surface || job->loaded;
+        SDL_AtomicSet(&job->state, ok ? ASSET_JOB_STATE_Decoded : ASSET_JOB_STATE_Failed);
+    }
+    return 0;
+}
+
+void asset_loader_start(AssetLoader* loader) {
+    int cpu_count = SDL_GetCPUCount();
+    int thread_count = cpu_count < ASSET_LOADER_MAX_THREADS ? cpu_count : ASSET_LOADER_MAX_THREADS;
+    thread_count = thread_count < loader->job_count ? thread_count : loader->job_count;
+
+    for(int i = 0; i < thread_count; i++) {
+        SDL_Thread* thread = SDL_CreateThread(asset_loader__worker, "asset_loader", loader);
+        if(thread) {
+            loader->threads[loader->thread_count] = thread;
+            loader->thread_count++;
+        }
+    }
+
+    //no threads at all, everything loads right here
+    if(loader->thread_count == 0) {
+        asset_loader__worker(loader);
+    }
+}
+
+bool asset_loader_poll(AssetLoader* loader, SDL_Renderer* renderer) {
+    for(int i = 0; i < loader->job_count && loader->finished_count < loader->job_count; i++) {
+        AssetJob* job = &loader->jobs[i];
+        if(job->finished) {
+            continue;
+        }
+
+        int state = SDL_AtomicGet(&job->state);
+        if(state == ASSET_JOB_STATE_Decoded) {
+            if(job->surface) {
+                *job->target = SDL_CreateTextureFromSurface(renderer, job->surface);
+                loader->texture_creations++;
+                SDL_FreeSurface(job->surface);
+                job->surface = NULL;
+            }
+            else {
+                *job->target = job->loaded;
+                job->loaded = NULL;
+            }
+            state = *job->target ? ASSET_JOB_STATE_Done : ASSET_JOB_STATE_Failed;
+            SDL_AtomicSet(&job->state, state);
+        }
+
+        if(state == ASSET_JOB_STATE_Done || state == ASSET_JOB_STATE_Failed) {
+            if(state == ASSET_JOB_STATE_Failed) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "failed to load %s: %s", job->path, SDL_GetError());
+            }
+            else {
+                double ms = (double)job->decode_ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+                SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "loaded %s, %.1f ms on a worker", job->path, ms);
+            }
+            job->finished = true;
+            loader->finished_count++;
+        }
+    }
+    return loader->finished_count == loader->job_count;
+}
+
+bool asset_loader_job_finished(AssetLoader* loader, int job) {
+    if(job < 0 || job >= loader->job_count) {
+        return true;
+    }
+    return loader->jobs[job].finished;
+}
+
+void asset_loader_deinit(AssetLoader* loader) {
+    SDL_AtomicSet(&loader->cancel, 1);
+    for(int i = 0; i < loader->thread_count; i++) {
+        SDL_WaitThread(loader->threads[i], NULL);
+    }
+    loader->thread_count = 0;
+
+    //decoded but never handed out
+    for(int i = 0; i < loader->job_count; i++) {
+        AssetJob* job = &loader->jobs[i];
+        if(SDL_AtomicGet(&job->state) != ASSET_JOB_STATE_Decoded) {
+            continue;
+        }
+        SDL_FreeSurface(job->surface);
+        if(job->loaded) {
+            switch (job->kind) {
+            case ASSET_KIND_Chunk:
+            case ASSET_KIND_Music:
+                Mix_FreeChunk(job->loaded);
+                break;
+            case ASSET_KIND_Font:
+                TTF_CloseFont(job->loaded);
+                break;
+            default:
+                break;
+            }
+        }
+        job->surface = NULL;
+        job->loaded = NULL;
+    }
+
+    SDL_DestroyMutex(loader->font_mutex);
+    loader->font_mutex = NULL;
+    SDL_DestroyMutex(loader->mixer_mutex);
+    loader->mixer_mutex = NULL;
+}
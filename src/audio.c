@@ -0,0 +1,216 @@
+#include <stdio.h>
+
+#include "audio.h"
+
+//starts what the game loop queued, runs on the audio thread where SDL skips the device lock Mix_PlayChannel takes
+static void audio__drain(Audio* audio) {
+    AudioQueue* queue = &audio->queue;
+    int head = SDL_AtomicGet(&queue->head);
+    int tail = SDL_AtomicGet(&queue->tail);
+    int steals = 0;
+    for(; head != tail; head++) {
+        AudioEvent event = queue->events[head & (AUDIO_QUEUE_CAPACITY - 1)];
+        int channel = Mix_GroupAvailable(AUDIO_SFX_GROUP);
+        if(channel < 0) {
+            channel = Mix_GroupOldest(AUDIO_SFX_GROUP);
+            steals++;
+        }
+        Mix_PlayChannel(channel, event.chunk, event.loops);
+    }
+    SDL_AtomicSet(&queue->head, head);
+
+    if(steals > 0) {
+        SDL_AtomicLock(&audio->stats_lock);
+        audio->stats.steals += steals;
+        SDL_AtomicUnlock(&audio->stats_lock);
+    }
+}
+
+//the music hook is the first thing SDL_mixer runs in its callback, the real music plays as a chunk so nothing is lost
+static void SDLCALL audio__begin(void* data, Uint8* stream, int length) {
+    (void)stream;
+    (void)length;
+    Audio* audio = data;
+    Uint64 now = SDL_GetPerformanceCounter();
+    audio->callback_start = now;
+
+    //the device drains a buffer every buffer_ticks, a callback later than one buffer past its due time underran
+    bool underrun = false;
+    Uint64 due = audio->anchor + audio->buffers_since_anchor * audio->buffer_ticks;
+    if(audio->anchor == 0 || now > due) {
+        underrun = audio->anchor != 0 && now - due > audio->buffer_ticks;
+        audio->anchor = now;//late but within the slack, also soaks up drift between the two clocks
+        audio->buffers_since_anchor = 0;
+    }
+    audio->buffers_since_anchor++;
+
+    if(underrun) {
+        SDL_AtomicLock(&audio->stats_lock);
+        audio->stats.underruns++;
+        SDL_AtomicUnlock(&audio->stats_lock);
+    }
+
+    //before SDL_mixer mixes the channels, so the sounds are heard in this very buffer
+    audio__drain(audio);
+}
+
+//and the post mix is the last
+static void SDLCALL audio__end(void* data, Uint8* stream, int length) {
+    (void)stream;
+    (void)length;
+    Audio* audio = data;
+    Uint64 ticks = SDL_GetPerformanceCounter() - audio->callback_start;
+
+    SDL_AtomicLock(&audio->stats_lock);
+    audio->stats.callbacks++;
+    audio->stats.callback_ticks += ticks;
+    audio->stats.max_callback_ticks = ticks > audio->stats.max_callback_ticks ? ticks : audio->stats.max_callback_ticks;
+    SDL_AtomicUnlock(&audio->stats_lock);
+}
+
+bool audio_open(Audio* audio, int buffer_frames) {
+    *audio = (Audio) { 0 };
+
+    //frequency and channel changes are allowed so SDL doesn't resample behind the mixer, chunks get converted when they load
+    if(Mix_OpenAudioDevice(AUDIO_FREQUENCY, AUDIO_S16SYS, 1, buffer_frames, NULL, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE) != 0) {
+        return false;
+    }
+    Mix_QuerySpec(&audio->frequency, &audio->format, &audio->channels);
+    Mix_AllocateChannels(AUDIO_CHANNELS);
+    Mix_ReserveChannels(AUDIO_MUSIC_CHANNEL + 1);
+    Mix_GroupChannels(AUDIO_MUSIC_CHANNEL + 1, AUDIO_CHANNELS - 1, AUDIO_SFX_GROUP);
+
+    audio->open = true;
+    audio->buffer_frames = buffer_frames;
+    audio->buffer_ticks = SDL_GetPerformanceFrequency() * (Uint64)buffer_frames / (Uint64)audio->frequency;
+    Mix_HookMusic(audio__begin, audio);
+    Mix_SetPostMix(audio__end, audio);
+
+    SDL_Log(
+        "audio: %d Hz, %d channels, %d frames per buffer (%.1f ms)",
+        audio->frequency,
+        audio->channels,
+        buffer_frames,
+        (double)buffer_frames * 1000.0 / (double)audio->frequency
+    );
+    return true;
+}
+
+void audio_close(Audio* audio) {
+    if(!audio->open) {
+        return;
+    }
+    Mix_HookMusic(NULL, NULL);
+    Mix_SetPostMix(NULL, NULL);
+    Mix_CloseAudio();
+    audio->open = false;
+}
+
+AudioStats audio_take_stats(Audio* audio) {
+    SDL_AtomicLock(&audio->stats_lock);
+    AudioStats stats = audio->stats;
+    audio->stats = (AudioStats) { 0 };
+    SDL_AtomicUnlock(&audio->stats_lock);
+    stats.dropped = SDL_AtomicSet(&audio->queue.dropped, 0);
+    return stats;
+}
+
+bool audio_play(Audio* audio, Mix_Chunk* chunk, int loops) {
+    if(!audio->open || !chunk) {
+        return false;
+    }
+
+    AudioQueue* queue = &audio->queue;
+    int tail = SDL_AtomicGet(&queue->tail);
+    if(tail - SDL_AtomicGet(&queue->head) >= AUDIO_QUEUE_CAPACITY) {
+        SDL_AtomicIncRef(&queue->dropped);
+        return false;
+    }
+    queue->events[tail & (AUDIO_QUEUE_CAPACITY - 1)] = (AudioEvent) { .chunk = chunk, .loops = loops };
+    SDL_AtomicSet(&queue->tail, tail + 1);//full barrier, the mixer never sees the index before the event
+    return true;
+}
+
+static Mix_Chunk* audio__read_cache(const char* cache_path, const AudioCacheHeader* expected) {
+    SDL_RWops* rw = SDL_RWFromFile(cache_path, "rb");
+    if(!rw) {
+        return NULL;
+    }
+
+    AudioCacheHeader header;
+    Uint8* samples = NULL;
+    if(SDL_RWread(rw, &header, sizeof(header), 1) == 1
+       && header.magic == expected->magic
+       && header.version == expected->version
+       && header.source_size == expected->source_size
+       && header.source_crc == expected->source_crc
+       && header.frequency == expected->frequency
+       && header.format == expected->format
+       && header.channels == expected->channels
+       && header.data_size > 0) {
+        samples = SDL_malloc(header.data_size);
+        if(samples && SDL_RWread(rw, samples, header.data_size, 1) != 1) {
+            SDL_free(samples);
+            samples = NULL;
+        }
+    }
+    SDL_RWclose(rw);
+    if(!samples) {
+        return NULL;
+    }
+
+    Mix_Chunk* chunk = Mix_QuickLoad_RAW(samples, header.data_size);
+    if(!chunk) {
+        SDL_free(samples);
+        return NULL;
+    }
+    chunk->allocated = 1;//Mix_FreeChunk frees the samples with the chunk
+    return chunk;
+}
+
+static void audio__write_cache(const char* cache_path, AudioCacheHeader header, const Mix_Chunk* chunk) {
+    SDL_RWops* rw = SDL_RWFromFile(cache_path, "wb");
+    if(!rw) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "can't write %s: %s", cache_path, SDL_GetError());
+        return;
+    }
+    header.data_size = chunk->alen;
+    bool ok = SDL_RWwrite(rw, &header, sizeof(header), 1) == 1 && SDL_RWwrite(rw, chunk->abuf, chunk->alen, 1) == 1;
+    if(SDL_RWclose(rw) != 0 || !ok) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "can't write %s: %s", cache_path, SDL_GetError());
+        remove(cache_path);
+    }
+}
+
+Mix_Chunk* audio_load_track(SDL_RWops* rw, const char* cache_path) {
+    size_t source_size;
+    void* source = SDL_LoadFile_RW(rw, &source_size, 1);
+    if(!source) {
+        return NULL;
+    }
+
+    int frequency;
+    Uint16 format;
+    int channels;
+    Mix_QuerySpec(&frequency, &format, &channels);
+    AudioCacheHeader header = {
+        .magic = AUDIO_CACHE_MAGIC,
+        .version = AUDIO_CACHE_VERSION,
+        .source_size = (Uint32)source_size,
+        .source_crc = SDL_crc32(0, source, source_size),
+        .frequency = (Uint32)frequency,
+        .format = format,
+        .channels = (Uint16)channels,
+    };
+
+    Mix_Chunk* chunk = cache_path ? audio__read_cache(cache_path, &header) : NULL;
+    if(!chunk) {
+        //the only time the compressed track gets decoded
+        chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(source, (int)source_size), 1);
+        if(chunk && cache_path) {
+            audio__write_cache(cache_path, header, chunk);
+        }
+    }
+    SDL_free(source);
+    return chunk;
+}
@@ -0,0 +1,154 @@
+#include "controller_db.h"
+
+static Uint32 controller_db__current_platform(void) {
+    static const char* const names[] = CONTROLLER_DB_PLATFORM_NAMES;
+    const char* platform = SDL_GetPlatform();
+    for(Uint32 i = 1; i < CONTROLLER_DB_PLATFORM_Count; i++) {
+        if(SDL_strcmp(names[i], platform) == 0) {
+            return i;
+        }
+    }
+    return CONTROLLER_DB_PLATFORM_Any;//only the lines without a platform apply
+}
+
+//mapping offsets must land in the zero terminated strings, platforms must be known and guids sorted for the bisection
+static bool controller_db__validate(ControllerDb* db, size_t size) {
+    if(size < sizeof(ControllerDbHeader)) {
+        return false;
+    }
+    const ControllerDbHeader* header = (const ControllerDbHeader*)db->data;
+    if(SDL_SwapLE32(header->magic) != CONTROLLER_DB_MAGIC || SDL_SwapLE32(header->version) != CONTROLLER_DB_VERSION) {
+        return false;
+    }
+
+    Uint32 entry_count = SDL_SwapLE32(header->entry_count);
+    Uint32 strings_size = SDL_SwapLE32(header->strings_size);
+    if(entry_count > (size - sizeof(ControllerDbHeader)) / sizeof(ControllerDbEntry)) {
+        return false;
+    }
+    size_t strings_offset = sizeof(ControllerDbHeader) + sizeof(ControllerDbEntry) * entry_count;
+    if(strings_size == 0 || strings_size > size - strings_offset) {
+        return false;
+    }
+
+    const ControllerDbEntry* entries = (const ControllerDbEntry*)((const Uint8*)db->data + sizeof(ControllerDbHeader));
+    const char* strings = (const char*)db->data + strings_offset;
+    if(strings[strings_size - 1] != '\0') {
+        return false;
+    }
+    for(Uint32 i = 0; i < entry_count; i++) {
+        if(SDL_SwapLE32(entries[i].mapping) >= strings_size || SDL_SwapLE32(entries[i].platform) >= CONTROLLER_DB_PLATFORM_Count) {
+            return false;
+        }
+        if(i > 0 && SDL_memcmp(entries[i - 1].guid, entries[i].guid, sizeof(entries[i].guid)) > 0) {
+            return false;
+        }
+    }
+
+    db->entries = entries;
+    db->entry_count = entry_count;
+    db->strings = strings;
+    return true;
+}
+
+bool controller_db_load(ControllerDb* db, SDL_RWops* rw) {
+    *db = (ControllerDb) { 0 };
+    db->platform = controller_db__current_platform();
+    if(!rw) {
+        return false;
+    }
+
+    size_t size;
+    db->data = SDL_LoadFile_RW(rw, &size, 1);
+    if(!db->data) {
+        return false;
+    }
+    if(!controller_db__validate(db, size)) {
+        SDL_SetError("not a valid controller db");
+        controller_db_free(db);
+        return false;
+    }
+    return true;
+}
+
+void controller_db_free(ControllerDb* db) {
+    Uint32 platform = db->platform;
+    SDL_free(db->data);
+    *db = (ControllerDb) { 0 };
+    db->platform = platform;
+}
+
+static const char* controller_db__find_exact(const ControllerDb* db, SDL_JoystickGUID guid) {
+    //first entry with this guid, entries are sorted by guid
+    Uint32 low = 0;
+    Uint32 high = db->entry_count;
+    while(low < high) {
+        Uint32 middle = low + (high - low) / 2;
+        if(SDL_memcmp(db->entries[middle].guid, guid.data, sizeof(guid.data)) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    //one entry per platform at most, a platform specific one wins over a generic one
+    const char* found = NULL;
+    for(Uint32 i = low; i < db->entry_count && SDL_memcmp(db->entries[i].guid, guid.data, sizeof(guid.data)) == 0; i++) {
+        Uint32 platform = SDL_SwapLE32(db->entries[i].platform);
+        if(platform == db->platform && platform != CONTROLLER_DB_PLATFORM_Any) {
+            return db->strings + SDL_SwapLE32(db->entries[i].mapping);
+        }
+        if(platform == CONTROLLER_DB_PLATFORM_Any) {
+            found = db->strings + SDL_SwapLE32(db->entries[i].mapping);
+        }
+    }
+    return found;
+}
+
+//clears what SDL doesn't require to match, false when there was nothing to clear
+//only guids laid out as bus, crc, vendor, 0, product, 0, version, driver have those fields
+static bool controller_db__loosen_guid(SDL_JoystickGUID* guid) {
+    Uint8* data = guid->data;
+    bool has_ids = (data[4] || data[5]) && (data[8] || data[9]);
+    if(!has_ids || data[6] || data[7] || data[10] || data[11]) {
+        return false;
+    }
+    bool loosened = data[2] || data[3] || data[12] || data[13];
+    data[2] = data[3] = 0;//crc of the device name, newer SDLs put it there, the db never has it
+    data[12] = data[13] = 0;//version, SDL retries without it too
+    return loosened;
+}
+
+const char* controller_db_find(const ControllerDb* db, SDL_JoystickGUID guid) {
+    const char* mapping = controller_db__find_exact(db, guid);
+    if(!mapping && controller_db__loosen_guid(&guid)) {
+        mapping = controller_db__find_exact(db, guid);
+    }
+    return mapping;
+}
+
+bool controller_db_add_device(const ControllerDb* db, int device_index) {
+    const char* mapping = controller_db_find(db, SDL_JoystickGetDeviceGUID(device_index));
+    return mapping && SDL_GameControllerAddMapping(mapping) >= 0;
+}
+
+int controller_db_add_all(const ControllerDb* db) {
+    int added = 0;
+    for(Uint32 i = 0; i < db->entry_count; i++) {
+        Uint32 platform = SDL_SwapLE32(db->entries[i].platform);
+        if(platform != CONTROLLER_DB_PLATFORM_Any && platform != db->platform) {
+            continue;
+        }
+        if(SDL_GameControllerAddMapping(db->strings + SDL_SwapLE32(db->entries[i].mapping)) >= 0) {
+            added++;
+        }
+    }
+    return added;
+}
+
+bool controller_db_add_defaults(const ControllerDb* db) {
+    static const SDL_JoystickGUID zero = { { 0 } };
+    const char* mapping = controller_db_find(db, zero);
+    return mapping && SDL_GameControllerAddMapping(mapping) >= 0;
+}
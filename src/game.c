@@ -0,0 +1,162 @@
+#include "game.h"
+
+void game_data_init(GameData* game_data, Uint64 seed) {
+    game_data->seed = seed;
+    rng_seed(&game_data->world_rng, seed);
+    rng_seed(&game_data->rng, seed + 1);
+    game_data->game_state = GAME_STATE_Start;
+    game_data->best_score = -1;
+    game_data->sound_count = 0;
+    world_init(&game_data->world, GAME_WORLD_W, GAME_WORLD_H);
+}
+
+void game_data_deinit(GameData* game_data) {
+    world_deinit(&game_data->world);
+}
+
+void game_data_reset(GameData* game_data) {
+    vine_reset(&game_data->vine, (HF_Vec2f) { 200.f, 200.f }, 0.f);
+    game_data->vine_speed = 2.f;
+    game_data->vine_go = false;
+    game_data->counter = 0.f;
+    game_data->score = 0;
+
+    game_data->tuto_flash = false;
+    game_data->tuto_timer = 0.f;
+
+    world_generate(&game_data->world, &game_data->world_rng);
+}
+
+static void game_data__emit_sound(GameData* game_data, GameSound sound, int variant) {
+    if(game_data->sound_count < GAME_MAX_SOUNDS) {
+        game_data->sounds[game_data->sound_count] = (GameSoundEvent) { sound, variant };
+        game_data->sound_count++;
+    }
+}
+
+static void game_data__update_best_score(GameData* game_data) {
+    if(game_data->score > game_data->best_score) {
+        game_data->best_score = game_data->score;
+    }
+}
+
+static void game_data__switch_game_state(GameData* game_data, GameState new_state) {
+    //deinit current state
+
+    //init new_state
+    switch (new_state) {
+    case GAME_STATE_Play:
+        game_data_reset(game_data);
+        game_data__update_best_score(game_data);
+        break;
+    default:
+        break;
+    }
+    game_data->game_state = new_state;
+}
+
+void game_data_update(GameData* game_data, GameInput input, float delta) {
+    //only the play state turns the vine, every other tick draws the tip where it is
+    vine_hold(&game_data->vine);
+
+    switch (game_data->game_state) {
+    case GAME_STATE_Start:
+        if(input.ok) {
+            game_data__switch_game_state(game_data, GAME_STATE_Play);
+        }
+        break;
+    case GAME_STATE_Play:
+        if(!game_data->vine_go) {
+            if(input.ok) {
+                game_data->vine_go = true;
+            }
+
+            game_data->tuto_timer += delta;
+            if(game_data->tuto_timer > 0.f) {
+                game_data->tuto_timer -= 1.f;
+                game_data->tuto_flash = !game_data->tuto_flash;
+            }
+        }
+
+        if(
+            vine_collision_self(&game_data->vine, NULL) ||
+            world_point_is_off_world(&game_data->world, game_data->vine.position) ||
+            game_data->vine_speed < 0.01
+        ) {
+            game_data__switch_game_state(game_data, GAME_STATE_Start);
+        }
+
+        bool in_bubble = world_point_is_in_bubble(&game_data->world, vine_next_point(&game_data->vine));
+
+        if(game_data->vine_go) {
+            game_data->counter += delta * game_data->vine_speed;
+            if(game_data->counter >= .3f) {
+                game_data->counter -= .3f;
+                game_data->score++;
+                game_data__update_best_score(game_data);
+                vine_expand(&game_data->vine);
+                if(rng_range(&game_data->rng, 4) == 0) {
+                    game_data__emit_sound(game_data, GAME_SOUND_Leaves, rng_range(&game_data->rng, 5));
+                }
+            }
+
+            if(in_bubble) {
+                game_data->vine_speed += delta * 1.4f;
+                if(game_data->vine_speed > GAME_MAX_SPEED) {
+                    game_data->vine_speed = GAME_MAX_SPEED;
+                }
+            }
+            else {
+                game_data->vine_speed -= delta * .2f;
+                if(game_data->vine_speed < 0.f) {
+                    game_data->vine_speed = 0.f;
+                }
+            }
+        }
+
+        float turn_value = in_bubble ? 1.2f : 3.5f;
+        vine_process_input(&game_data->vine, input.vine_input, turn_value, delta);
+        break;
+    default:
+        break;
+    }
+}
+
+static Uint64 game_data__hash_bytes(Uint64 hash, const void* data, size_t size) {
+    const Uint8* bytes = data;
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+Uint64 game_data_hash(GameData* game_data) {
+    Uint64 hash = 0xcbf29ce484222325ull;
+    hash = game_data__hash_bytes(hash, &game_data->world_rng, sizeof(game_data->world_rng));
+    hash = game_data__hash_bytes(hash, &game_data->rng, sizeof(game_data->rng));
+
+    //field by field, the padding between them is not state
+    hash = game_data__hash_bytes(hash, &game_data->counter, sizeof(game_data->counter));
+    hash = game_data__hash_bytes(hash, &game_data->vine_speed, sizeof(game_data->vine_speed));
+    hash = game_data__hash_bytes(hash, &game_data->vine_go, sizeof(game_data->vine_go));
+    hash = game_data__hash_bytes(hash, &game_data->score, sizeof(game_data->score));
+    hash = game_data__hash_bytes(hash, &game_data->best_score, sizeof(game_data->best_score));
+    hash = game_data__hash_bytes(hash, &game_data->game_state, sizeof(game_data->game_state));
+    hash = game_data__hash_bytes(hash, &game_data->tuto_flash, sizeof(game_data->tuto_flash));
+    hash = game_data__hash_bytes(hash, &game_data->tuto_timer, sizeof(game_data->tuto_timer));
+
+    Vine* vine = &game_data->vine;
+    hash = game_data__hash_bytes(hash, &vine->position, sizeof(vine->position));
+    hash = game_data__hash_bytes(hash, &vine->angle, sizeof(vine->angle));
+    hash = game_data__hash_bytes(hash, &vine->previous_angle, sizeof(vine->previous_angle));
+    VineIterator iterator = vine_iterator(vine);
+    HF_Vec2f point;
+    while(vine_iterator_next(&iterator, &point)) {
+        hash = game_data__hash_bytes(hash, &point, sizeof(point));
+    }
+
+    World* world = &game_data->world;
+    hash = game_data__hash_bytes(hash, &world->bubble_count, sizeof(world->bubble_count));
+    hash = game_data__hash_bytes(hash, world->bubbles, sizeof(HF_Circle) * (size_t)world->bubble_count);
+    return hash;
+}
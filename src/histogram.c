@@ -0,0 +1,49 @@
+#include "histogram.h"
+#include "SDL2/SDL_bits.h"
+
+static int histogram__bucket(Uint32 value) {
+    if(value < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return (int)value;
+    }
+    //value >> shift lands in [HISTOGRAM_SUB_BUCKETS, 2 * HISTOGRAM_SUB_BUCKETS), each shift adds a row of buckets
+    int shift = SDL_MostSignificantBitIndex32(value) - HISTOGRAM_SUB_BITS;
+    return shift * HISTOGRAM_SUB_BUCKETS + (int)(value >> shift);
+}
+
+static Uint32 histogram__bucket_highest(int bucket) {
+    if(bucket < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return (Uint32)bucket;
+    }
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    Uint64 mantissa = (Uint64)(bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS);
+    return (Uint32)(((mantissa + 1) << shift) - 1);
+}
+
+void histogram_reset(Histogram* histogram) {
+    SDL_memset(histogram, 0, sizeof(*histogram));
+}
+
+void histogram_record(Histogram* histogram, Uint32 value) {
+    histogram->counts[histogram__bucket(value)]++;
+    histogram->total++;
+    histogram->max = SDL_max(histogram->max, value);
+}
+
+Uint32 histogram_percentile(const Histogram* histogram, double percentile) {
+    if(histogram->total == 0) {
+        return 0;
+    }
+
+    //rank of the value, 1 based, at least the first one
+    Uint64 rank = (Uint64)SDL_ceil(percentile / 100.0 * (double)histogram->total);
+    rank = SDL_clamp(rank, 1, histogram->total);
+
+    Uint64 seen = 0;
+    for(int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if(seen >= rank) {
+            return SDL_min(histogram__bucket_highest(i), histogram->max);
+        }
+    }
+    return histogram->max;
+}
@@ -10,14 +10,26 @@
 #include "hf_triangle.h"
 #include "hf_circle.h"
 #include "hf_intersection.h"
-
+#include "hf_batch.h"
+
+#include "asset_loader.h"
+#include "audio.h"
+#include "controller_db.h"
+#include "game.h"
+#include "histogram.h"
+#include "profiler.h"
+#include "replay.h"
+#include "text.h"
+#include "timestep.h"
 #include "vine.h"
 #include "world.h"
 
 #define WIN_W 1920
 #define WIN_H 1080
 
-#define MAX_SPEED 5.f
+#define FONT_TITLE_SIZE 198
+#define FONT_SCORE_SIZE 24
+
 #define SPEEDBAR_W 400
 #define SPEEDBAR_H 15
 
@@ -85,36 +97,11 @@ void change_color_if(SDL_Renderer* renderer, bool condition) {
     }
 }
 
-SDL_Texture* load_texture(SDL_Renderer* renderer, const char* path, bool use_keying) {
-    SDL_Texture* tex = NULL;
-    SDL_Surface* surf = SDL_LoadBMP(path);
-    if(surf) {
-        if(use_keying) {
-            SDL_SetColorKey(surf, SDL_TRUE, SDL_MapRGB(surf->format, 255, 0, 255));
-        }
-        tex = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-
-    return tex;
-}
-
-void draw_tiled(SDL_Renderer* renderer, SDL_Texture* texture, int pos_x, int pos_y, int repeat_x, int repeat_y) {
-    int tex_w;
-    int tex_h;
-    SDL_QueryTexture(texture, NULL, NULL, &tex_w, &tex_h);
+int texture_creations = 0;//every texture main creates, read by the frame counters
 
-    for(int x = 0; x < repeat_x; x++) {
-        for(int y = 0; y < repeat_y; y++) {
-            SDL_Rect dest_rect = {
-                pos_x + x * tex_w,
-                pos_y + y * tex_h,
-                tex_w,
-                tex_h,
-            };
-            SDL_RenderCopy(renderer, texture, NULL, &dest_rect);
-        }
-    }
+SDL_Texture* create_texture_from_surface(SDL_Renderer* renderer, SDL_Surface* surface) {
+    texture_creations++;
+    return SDL_CreateTextureFromSurface(renderer, surface);
 }
 
 void update_font_texture(SDL_Texture** texture_ptr, SDL_Renderer* renderer, TTF_Font* font, const char* text) {
@@ -123,7 +110,7 @@ void update_font_texture(SDL_Texture** texture_ptr, SDL_Renderer* renderer, TTF_
     }
     SDL_Surface* surf = TTF_RenderText_Solid(font, text, (SDL_Color) { 255, 255, 255, 255 });
     if(surf) {
-        *texture_ptr = SDL_CreateTextureFromSurface(renderer, surf);
+        *texture_ptr = create_texture_from_surface(renderer, surf);
         SDL_FreeSurface(surf);
     }
 }
@@ -136,67 +123,129 @@ typedef struct AssetData_s {
 
     Mix_Chunk* leaves_chunks[5];
 
-    Mix_Music* music_fast;
+    Mix_Chunk* music_fast;//decoded up front, plays on AUDIO_MUSIC_CHANNEL
+    bool music_started;
 
-    TTF_Font* font_score;
-    TTF_Font* font_title;
+    TTF_Font* font;//opened once, at the title size until the title is drawn, then at the score size
 
-    SDL_Texture* text_play_score;
-    SDL_Texture* text_play_best_score;
+    TextAtlas atlas_score;//score size glyphs, the score texts change too often for a texture each
+    char text_play_score[32];
+    char text_play_best_score[32];
+    int shown_score;//values the two texts above were formatted with
+    int shown_best_score;
 
     SDL_Texture* text_start_title;
+
+    Pak pak;//every asset comes from this mapping when ./assets.pak exists
+    char* cache_dir;//user folder the decoded music is kept in
+    AssetLoader loader;
+    int title_jobs[4];//what the title screen needs, loaded first
+    bool title_ready;
+    bool ready;//everything loaded, the game can start
 } AssetData;
 
-void asset_data_init(AssetData* asset_data, SDL_Renderer* renderer) {
-    asset_data->tex_plants = load_texture(renderer, "./assets/sprites/plants.bmp", true);
-    asset_data->tex_ground = load_texture(renderer, "./assets/sprites/ground.bmp", false);
-    asset_data->tex_water = load_texture(renderer, "./assets/sprites/water.bmp", false);
-    asset_data->tex_tuto = load_texture(renderer, "./assets/sprites/tuto.bmp", true);
+//only queues the files, asset_data_poll hands them out as the workers finish
+void asset_data_init(AssetData* asset_data) {
+    if(!pak_open(&asset_data->pak, "./assets.pak")) {
+        SDL_Log("no assets.pak (%s), loading loose files", SDL_GetError());
+    }
 
-    asset_data->leaves_chunks[0] = Mix_LoadWAV("./assets/sfx/leaves00.wav");
-    asset_data->leaves_chunks[1] = Mix_LoadWAV("./assets/sfx/leaves01.wav");
-    asset_data->leaves_chunks[2] = Mix_LoadWAV("./assets/sfx/leaves02.wav");
-    asset_data->leaves_chunks[3] = Mix_LoadWAV("./assets/sfx/leaves03.wav");
-    asset_data->leaves_chunks[4] = Mix_LoadWAV("./assets/sfx/leaves04.wav");
-    for(int i= 0; i < 5; i++) {
-        Mix_VolumeChunk(asset_data->leaves_chunks[i], MIX_MAX_VOLUME / 4);
+    asset_data->cache_dir = SDL_GetPrefPath("", "trepadeira");
+    if(!asset_data->cache_dir) {
+        SDL_Log("no cache folder (%s), the music is decoded on every launch", SDL_GetError());
     }
 
-    asset_data->music_fast = Mix_LoadMUS("./assets/music/fast.mp3");
+    AssetLoader* loader = &asset_data->loader;
+    asset_loader_init(loader, &asset_data->pak, "./assets/", asset_data->cache_dir);
+
+    asset_data->title_jobs[0] = asset_loader_add(loader, ASSET_KIND_KeyedTexture, "sprites/plants.bmp", 0, &asset_data->tex_plants);
+    asset_data->title_jobs[1] = asset_loader_add(loader, ASSET_KIND_Texture, "sprites/ground.bmp", 0, &asset_data->tex_ground);
+    asset_data->title_jobs[2] = asset_loader_add(loader, ASSET_KIND_Texture, "sprites/water.bmp", 0, &asset_data->tex_water);
+    asset_data->title_jobs[3] = asset_loader_add(loader, ASSET_KIND_Font, "fonts/arial.ttf", FONT_TITLE_SIZE, &asset_data->font);
+
+    asset_loader_add(loader, ASSET_KIND_KeyedTexture, "sprites/tuto.bmp", 0, &asset_data->tex_tuto);
+    asset_loader_add(loader, ASSET_KIND_Music, "music/fast.mp3", 0, &asset_data->music_fast);
+    asset_loader_add(loader, ASSET_KIND_Chunk, "sfx/leaves00.wav", 0, &asset_data->leaves_chunks[0]);
+    asset_loader_add(loader, ASSET_KIND_Chunk, "sfx/leaves01.wav", 0, &asset_data->leaves_chunks[1]);
+    asset_loader_add(loader, ASSET_KIND_Chunk, "sfx/leaves02.wav", 0, &asset_data->leaves_chunks[2]);
+    asset_loader_add(loader, ASSET_KIND_Chunk, "sfx/leaves03.wav", 0, &asset_data->leaves_chunks[3]);
+    asset_loader_add(loader, ASSET_KIND_Chunk, "sfx/leaves04.wav", 0, &asset_data->leaves_chunks[4]);
+
+    asset_data->music_started = false;
+    asset_data->atlas_score = (TextAtlas) { 0 };
+    asset_data->text_play_score[0] = '\0';
+    asset_data->text_play_best_score[0] = '\0';
+    asset_data->shown_score = -1;
+    asset_data->shown_best_score = -2;//best_score starts at -1
+    asset_data->text_start_title = NULL;
+    asset_data->title_ready = false;
+    asset_data->ready = false;
 
-    asset_data->font_score = TTF_OpenFont("./assets/fonts/arial.ttf", 24);
-    asset_data->font_title = TTF_OpenFont("./assets/fonts/arial.ttf", 198);
+    asset_loader_start(loader);
+}
 
-    asset_data->text_play_score = NULL;
-    asset_data->text_play_best_score = NULL;
+//called every frame until everything is loaded, does the work that needs the main thread
+void asset_data_poll(AssetData* asset_data, SDL_Renderer* renderer) {
+    if(asset_data->ready) {
+        return;
+    }
+    AssetLoader* loader = &asset_data->loader;
+    bool all_finished = asset_loader_poll(loader, renderer);
+    texture_creations += loader->texture_creations;
+    loader->texture_creations = 0;
 
-    asset_data->text_start_title = NULL;
-    update_font_texture(&asset_data->text_start_title, renderer, asset_data->font_title, "TREPADEIRA");
+    if(!asset_data->text_start_title && asset_data->font) {
+        update_font_texture(&asset_data->text_start_title, renderer, asset_data->font, "TREPADEIRA");
+    }
+    if(asset_data->music_fast && !asset_data->music_started) {
+        Mix_PlayChannel(AUDIO_MUSIC_CHANNEL, asset_data->music_fast, -1);
+        asset_data->music_started = true;
+    }
+
+    if(!asset_data->title_ready) {
+        asset_data->title_ready = true;
+        for(int i = 0; i < 4; i++) {
+            asset_data->title_ready = asset_data->title_ready && asset_loader_job_finished(loader, asset_data->title_jobs[i]);
+        }
+    }
+
+    if(all_finished) {
+        for(int i = 0; i < 5; i++) {
+            Mix_VolumeChunk(asset_data->leaves_chunks[i], MIX_MAX_VOLUME / 4);
+        }
+        //the title is done with the font by now
+        if(asset_data->font) {
+            TTF_SetFontSize(asset_data->font, FONT_SCORE_SIZE);
+        }
+        if(text_atlas_init(&asset_data->atlas_score, renderer, asset_data->font)) {
+            texture_creations++;
+        }
+        asset_data->ready = true;
+    }
 }
 
 void asset_data_deinit(AssetData* asset_data) {
+    asset_loader_deinit(&asset_data->loader);
+
     SDL_DestroyTexture(asset_data->tex_ground);
     SDL_DestroyTexture(asset_data->tex_plants);
     SDL_DestroyTexture(asset_data->tex_water);
     SDL_DestroyTexture(asset_data->tex_tuto);
 
-    Mix_FreeMusic(asset_data->music_fast);
+    Mix_FreeChunk(asset_data->music_fast);
     for(int i = 0; i < 5; i++) {
         Mix_FreeChunk(asset_data->leaves_chunks[i]);
     }
 
-    SDL_DestroyTexture(asset_data->text_play_score);
-    SDL_DestroyTexture(asset_data->text_play_best_score);
+    text_atlas_deinit(&asset_data->atlas_score);
     SDL_DestroyTexture(asset_data->text_start_title);
 
-    TTF_CloseFont(asset_data->font_score);
-    TTF_CloseFont(asset_data->font_title);
-}
+    TTF_CloseFont(asset_data->font);
 
-typedef struct GameInput_s {
-    VineInput vine_input;
-    bool ok;
-} GameInput;
+    //the font was still reading from it
+    pak_close(&asset_data->pak);
+    SDL_free(asset_data->cache_dir);
+}
 
 void game_input_process_event(GameInput* game_input, SDL_Event e) {
     switch (e.type) {
@@ -246,286 +295,646 @@ void game_input_process_controller(GameInput* game_input, SDL_GameController* co
     }
 }
 
-typedef enum GameState_s {
-    GAME_STATE_Start,
-    GAME_STATE_Play,
-    GAME_STATE_Lost,
-} GameState;
-
-typedef struct GameData_s {
-    Vine vine;
-    World world;
-    float counter;
-    float vine_speed;
-    bool vine_go;
-    int score;
-    int best_score;
-    GameState game_state;
-    bool tuto_flash;
-    float tuto_timer;
-} GameData;
-
-void game_data_init(GameData* game_data, SDL_Renderer* renderer) {
-    game_data->game_state = GAME_STATE_Start;
-    game_data->best_score = -1;
-    world_init(&game_data->world, renderer, WIN_W / 2, WIN_H / 2);
+//score texts are formatted again only when the simulation values change
+void asset_data_update_score(AssetData* asset_data, GameData* game_data) {
+    if(asset_data->shown_score != game_data->score) {
+        SDL_snprintf(asset_data->text_play_score, sizeof(asset_data->text_play_score), "PONTOS: %d", game_data->score);
+        asset_data->shown_score = game_data->score;
+    }
+    if(asset_data->shown_best_score != game_data->best_score) {
+        SDL_snprintf(asset_data->text_play_best_score, sizeof(asset_data->text_play_best_score), "MELHOR: %d", game_data->best_score);
+        asset_data->shown_best_score = game_data->best_score;
+    }
 }
 
-void game_data_deinit(GameData* game_data) {
-    world_deinit(&game_data->world);
+//hands the sounds of the last ticks to the mixer thread, never waits on it
+void asset_data_play_sounds(AssetData* asset_data, GameData* game_data, Audio* audio) {
+    for(int i = 0; i < game_data->sound_count; i++) {
+        GameSoundEvent event = game_data->sounds[i];
+        switch (event.sound) {
+        case GAME_SOUND_Leaves:
+            audio_play(audio, asset_data->leaves_chunks[event.variant], 0);
+            break;
+        default:
+            break;
+        }
+    }
+    game_data->sound_count = 0;
 }
 
-void game_data_reset(GameData* game_data, SDL_Renderer* renderer) {
-    game_data->vine = (Vine) {
-        .position = { 200.f, 200.f },
-        .point_count = 0,
-        .angle = 0.f
-    };
-    game_data->vine_speed = 2.f;
-    game_data->vine_go = false;
-    game_data->counter = 0.f;
-    game_data->score = 0;
-
-    game_data->tuto_flash = false;
-    game_data->tuto_timer = 0.f;
+//shadow pass then the vine itself, only what reaches region when it isn't NULL
+void draw_vine_layer(Vine* vine, VineRender* vine_render, SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, SDL_Rect* region, Profiler* profiler) {
+    HF_Vec2f passes[2] = { { 0.f, 1.f }, { 0.f, 0.f } };
+    Uint8 pass_colors[2] = { 150, 255 };
+    ProfilerPhase pass_phases[2] = { PROFILER_PHASE_VineShadow, PROFILER_PHASE_Vine };
 
-    world_generate(&game_data->world, renderer);
+    for(int i = 0; i < 2; i++) PROFILER_SCOPE(profiler, pass_phases[i]) {
+        SDL_SetTextureColorMod(texture, pass_colors[i], pass_colors[i], pass_colors[i]);
+        if(region) {
+            vine_draw_region(vine, vine_render, renderer, texture, tex_offset_y, passes[i], *region);
+        }
+        else {
+            vine_draw(vine, vine_render, renderer, texture, tex_offset_y, passes[i]);
+        }
+    }
 }
 
-void game_data_update_score(GameData* game_data, AssetData* asset_data, SDL_Renderer* renderer) {
-    char buff[300];
-    sprintf(buff, "PONTOS: %d", game_data->score);
+void game_data_render(GameData* game_data, VineRender* vine_render, AssetData* asset_data, SDL_Renderer* renderer, bool accumulate_foreground, Profiler* profiler) {
+    SDL_SetRenderDrawColor(renderer, 100, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    //bg_ground and bg_sky are baked by the world, only the vine is drawn each frame
+    World* world = &game_data->world;
+    SDL_Rect damage[VINE_MAX_DAMAGE_RECTS];
+    int damage_count = vine_take_damage(&game_data->vine, vine_render, damage);
 
-    update_font_texture(&asset_data->text_play_score, renderer, asset_data->font_score, buff);
-    if(game_data->score > game_data->best_score) {
-        game_data->best_score = game_data->score;
+    if(!accumulate_foreground || damage_count < 0 || !world->foreground_valid) {
+        PROFILER_SCOPE(profiler, PROFILER_PHASE_WorldClear) {
+            world_clear(world, renderer);
+        }
 
-        sprintf(buff, "MELHOR: %d", game_data->best_score);
-        update_font_texture(&asset_data->text_play_best_score, renderer, asset_data->font_score, buff);
+        //fg_ground
+        SDL_SetRenderTarget(renderer, world->fg_ground);
+        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+        draw_vine_layer(&game_data->vine, vine_render, renderer, asset_data->tex_plants, 21, NULL, profiler);
+        //fg_sky
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_SetRenderTarget(renderer, world->fg_sky);
+        draw_vine_layer(&game_data->vine, vine_render, renderer, asset_data->tex_plants, 0, NULL, profiler);
     }
-}
+    else {
+        //fg_* still has the last frame, only what the vine changed is redrawn
+        for(int i = 0; i < damage_count; i++) {
+            PROFILER_SCOPE(profiler, PROFILER_PHASE_WorldClear) {
+                world_clear_region(world, renderer, damage[i]);
+            }
 
-void game_data_switch_game_state(GameData* game_data, AssetData* asset_data, GameState new_state, SDL_Renderer* renderer) {
-    //deinit current state
+            SDL_SetRenderTarget(renderer, world->fg_ground);
+            SDL_RenderSetClipRect(renderer, &damage[i]);
+            draw_vine_layer(&game_data->vine, vine_render, renderer, asset_data->tex_plants, 21, &damage[i], profiler);
 
-    //init new_state
-    switch (new_state) {
-    case GAME_STATE_Play:
-        game_data_reset(game_data, renderer);
-        game_data_update_score(game_data, asset_data, renderer);
-        break;
-    default:
-        break;
+            SDL_SetRenderTarget(renderer, world->fg_sky);
+            SDL_RenderSetClipRect(renderer, &damage[i]);
+            draw_vine_layer(&game_data->vine, vine_render, renderer, asset_data->tex_plants, 0, &damage[i], profiler);
+        }
     }
-    game_data->game_state = new_state;
-}
 
-void game_data_update(GameData* game_data, AssetData* asset_data, GameInput input, float delta, SDL_Renderer* renderer) {
-    switch (game_data->game_state) {
-    case GAME_STATE_Start:
-        if(input.ok) {
-            game_data_switch_game_state(game_data, asset_data, GAME_STATE_Play, renderer);
+    SDL_SetRenderTarget(renderer, NULL);
+    PROFILER_SCOPE(profiler, PROFILER_PHASE_Compose) {
+        world_compose_texture(&game_data->world, renderer);
+        SDL_RenderCopy(renderer, game_data->world.composed_all, NULL, NULL);
+    }
+
+    PROFILER_SCOPE(profiler, PROFILER_PHASE_Hud) {
+        switch (game_data->game_state) {
+        case GAME_STATE_Start: {
+            //desenhar trepadeira no meio da tela
+            int text_tile_w;
+            int text_tile_h;
+            SDL_QueryTexture(asset_data->text_start_title, NULL, NULL, &text_tile_w, &text_tile_h);
+
+            SDL_Rect dest_rect = {
+                WIN_W / 2 - text_tile_w / 2,
+                WIN_H / 2 - text_tile_h / 2,
+                text_tile_w,
+                text_tile_h,
+            };
+            SDL_SetTextureColorMod(asset_data->text_start_title, 0, 0, 0);
+            SDL_SetTextureAlphaMod(asset_data->text_start_title, 100);
+            SDL_RenderCopy(renderer, asset_data->text_start_title, NULL, &dest_rect);
+            dest_rect.x += 5;
+            dest_rect.y += 5;
+            SDL_SetTextureColorMod(asset_data->text_start_title, 150, 255, 150);
+            SDL_SetTextureAlphaMod(asset_data->text_start_title, 255);
+            SDL_RenderCopy(renderer, asset_data->text_start_title, NULL, &dest_rect);
+            break;
         }
-        break;
-    case GAME_STATE_Play:
-        if(!game_data->vine_go) {
-            if(input.ok) {
-                game_data->vine_go = true;
+        case GAME_STATE_Play: {
+            asset_data_update_score(asset_data, game_data);
+            if(!game_data->vine_go) {//render tutorial
+                int tex_w;
+                int tex_h;
+                SDL_QueryTexture(asset_data->tex_tuto, NULL, NULL, &tex_w, &tex_h);
+
+                SDL_Rect src_rect = {
+                    0,
+                    game_data->tuto_flash ? tex_h / 2 : 0,
+                    tex_w,
+                    tex_h / 2
+                };
+                SDL_Rect dest_rect = {
+                    WIN_W / 2 - tex_w / 2,
+                    WIN_H / 2 - tex_h / 4,
+                    tex_w,
+                    tex_h / 2
+                };
+                SDL_RenderCopy(renderer, asset_data->tex_tuto, &src_rect, &dest_rect);
+            }
+            {//render score texts
+                TextAtlas* atlas = &asset_data->atlas_score;
+                SDL_Color white = { 255, 255, 255, 255 };
+                text_draw(atlas, renderer, asset_data->text_play_score, 20, 40 + atlas->line_height / 2, white);
+                text_draw(atlas, renderer, asset_data->text_play_best_score, 20, 80 + atlas->line_height / 2, white);
             }
 
-            game_data->tuto_timer += delta;
-            if(game_data->tuto_timer > 0.f) {
-                game_data->tuto_timer -= 1.f;
-                game_data->tuto_flash = !game_data->tuto_flash;
+            //draw top bar
+            {
+                SDL_Rect bar_rect = {
+                    WIN_W / 2 - SPEEDBAR_W / 2,
+                    20,
+                    SPEEDBAR_W,
+                    SPEEDBAR_H,
+                };
+
+                float pct = game_data->vine_speed / GAME_MAX_SPEED;
+                SDL_Rect filled_rect = {
+                    bar_rect.x,
+                    bar_rect.y,
+                    (int)(pct * (float)SPEEDBAR_W),
+                    bar_rect.h,
+                };
+
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+                SDL_RenderDrawRect(renderer, &bar_rect);
+                SDL_RenderFillRect(renderer, &filled_rect);
             }
+            break;
         }
-
-        if(
-            vine_collision_self(&game_data->vine, NULL) ||
-            world_point_is_off_world(&game_data->world, game_data->vine.position) ||
-            game_data->vine_speed < 0.01
-        ) {
-            game_data_switch_game_state(game_data, asset_data, GAME_STATE_Start, renderer);
+        default:
+            break;
         }
+    }
+}
 
-        bool in_bubble = world_point_is_in_bubble(&game_data->world, vine_next_point(&game_data->vine));
+//per frame counters, averaged and logged about once a second
+typedef struct FrameCounters_s {
+    Uint64 window_start;
+    int frames;
+    int collision_tests;
+    Uint64 compose_ticks;
+
+    //texture creations are logged once a minute, they should stop after startup
+    Uint64 minute_start;
+    int texture_creations;
+
+    Audio* audio;//callback times are taken from it with every log
+} FrameCounters;
+
+void frame_counters_reset_window(FrameCounters* counters) {
+    counters->window_start = SDL_GetPerformanceCounter();
+    counters->frames = 0;
+    counters->collision_tests = 0;
+    counters->compose_ticks = 0;
+}
 
-        if(game_data->vine_go) {
-            game_data->counter += delta * game_data->vine_speed;
-            if(game_data->counter >= .3f) {
-                game_data->counter -= .3f;
-                game_data->score++;
-                game_data_update_score(game_data, asset_data, renderer);
-                vine_expand(&game_data->vine);
-                if((rand() % 4) == 0) {
-                    Mix_PlayChannel(-1, asset_data->leaves_chunks[rand() % 5], SDL_FALSE);
-                }
-            }
+void frame_counters_init(FrameCounters* counters, Audio* audio) {
+    frame_counters_reset_window(counters);
+    counters->audio = audio;
+    counters->minute_start = counters->window_start;
+    counters->texture_creations = 0;
+}
 
-            if(in_bubble) {
-                game_data->vine_speed += delta * 1.4f;
-                if(game_data->vine_speed > MAX_SPEED) {
-                    game_data->vine_speed = MAX_SPEED;
-                }
-            }
-            else {
-                game_data->vine_speed -= delta * .2f;
-                if(game_data->vine_speed < 0.f) {
-                    game_data->vine_speed = 0.f;
-                }
-            }
+void frame_counters_end_frame(FrameCounters* counters, GameData* game_data) {
+    counters->frames++;
+    counters->collision_tests += game_data->vine.collision_tests;
+    game_data->vine.collision_tests = 0;
+    counters->compose_ticks += game_data->world.compose_ticks;
+    game_data->world.compose_ticks = 0;
+    counters->texture_creations += texture_creations + game_data->world.texture_creations;
+    texture_creations = 0;
+    game_data->world.texture_creations = 0;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    if(now - counters->minute_start >= frequency * 60) {
+#ifndef NDEBUG
+        SDL_Log("texture creations in the last minute: %d", counters->texture_creations);
+#endif
+        counters->minute_start = now;
+        counters->texture_creations = 0;
+    }
+    if(now - counters->window_start < frequency) {
+        return;
+    }
+
+#ifndef NDEBUG
+    double frame_ms = (double)(now - counters->window_start) * 1000.0 / (double)frequency / (double)counters->frames;
+    double compose_ms = (double)counters->compose_ticks * 1000.0 / (double)frequency / (double)counters->frames;
+    SDL_Log(
+        "frame: %.2f ms, compose: %.3f ms, collision tests/frame: %.2f",
+        frame_ms,
+        compose_ms,
+        (double)counters->collision_tests / (double)counters->frames
+    );
+#endif
+    if(counters->audio->open) {
+        AudioStats audio_stats = audio_take_stats(counters->audio);
+#ifndef NDEBUG
+        SDL_Log(
+            "audio callback: %.3f ms avg, %.3f ms max of a %.3f ms buffer",
+            audio_stats.callbacks > 0 ? (double)audio_stats.callback_ticks * 1000.0 / (double)frequency / (double)audio_stats.callbacks : 0.0,
+            (double)audio_stats.max_callback_ticks * 1000.0 / (double)frequency,
+            (double)counters->audio->buffer_ticks * 1000.0 / (double)frequency
+        );
+#endif
+        if(audio_stats.underruns > 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "audio underruns in the last second: %d", audio_stats.underruns);
+        }
+        if(audio_stats.steals > 0 || audio_stats.dropped > 0) {
+            SDL_LogDebug(SDL_LOG_CATEGORY_AUDIO, "sounds cutting off others: %d, dropped: %d", audio_stats.steals, audio_stats.dropped);
         }
+    }
+    frame_counters_reset_window(counters);
+}
 
-        float turn_value = in_bubble ? 1.2f : 3.5f;
-        vine_process_input(&game_data->vine, input.vine_input, turn_value, delta);
-        break;
-    default:
-        break;
+#define FRAME_TIMES_DEFAULT_HITCH_MS 50.0//three frames at 60 Hz
+#define FRAME_TIMES_HITCH_FRAMES 120//written with each hitch, about 2 seconds at 60 Hz
+#define FRAME_TIMES_OVERLAY_KEY SDLK_F5
+
+//frame and simulation tick times of the whole session in microseconds, for the tail and not just the average
+typedef struct FrameTimes_s {
+    Histogram frames;//present to present, what the player sees
+    Histogram ticks;//one game_data_update each
+    Uint64 frame_start;
+    double hitch_ms;//longer frames have the phases before them written to disk, 0 turns it off
+    int hitch_cooldown;//frames until the next capture, writing one may cause another hitch
+    int hitches;
+    const char* output_dir;//ends with a separator, "" for the working directory
+    bool overlay;
+} FrameTimes;
+
+Uint32 ticks_to_us(Uint64 ticks) {
+    return (Uint32)SDL_min((double)ticks * 1e6 / (double)SDL_GetPerformanceFrequency(), (double)SDL_MAX_UINT32);
+}
+
+void frame_times_init(FrameTimes* frame_times, double hitch_ms, const char* output_dir) {
+    histogram_reset(&frame_times->frames);
+    histogram_reset(&frame_times->ticks);
+    frame_times->frame_start = 0;
+    frame_times->hitch_ms = hitch_ms;
+    frame_times->hitch_cooldown = 0;
+    frame_times->hitches = 0;
+    frame_times->output_dir = output_dir ? output_dir : "";
+    frame_times->overlay = false;
+}
+
+void frame_times_record_tick(FrameTimes* frame_times, Uint64 ticks) {
+    histogram_record(&frame_times->ticks, ticks_to_us(ticks));
+}
+
+//after profiler_end_frame, so the phases of the slow frame are already in the profiler
+void frame_times_end_frame(FrameTimes* frame_times, Profiler* profiler) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 start = frame_times->frame_start;
+    frame_times->frame_start = now;
+    frame_times->hitch_cooldown--;
+    if(start == 0) {//no previous frame to measure from
+        return;
     }
+
+    Uint32 frame_us = ticks_to_us(now - start);
+    histogram_record(&frame_times->frames, frame_us);
+    if(frame_times->hitch_ms <= 0.0 || (double)frame_us < frame_times->hitch_ms * 1000.0) {
+        return;
+    }
+
+    frame_times->hitches++;
+    if(frame_times->hitch_cooldown > 0) {
+        return;
+    }
+    frame_times->hitch_cooldown = FRAME_TIMES_HITCH_FRAMES;
+#ifdef PROFILER_ENABLED
+    char path[512];
+    SDL_snprintf(path, sizeof(path), "%shitch-%d.csv", frame_times->output_dir, profiler->frame - 1);
+    if(profiler_write_frames(profiler, path, FRAME_TIMES_HITCH_FRAMES)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "hitch: %.1f ms frame, phases of the last %d frames in %s", (double)frame_us / 1000.0, FRAME_TIMES_HITCH_FRAMES, path);
+    }
+    else {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "hitch: %.1f ms frame, couldn't write %s: %s", (double)frame_us / 1000.0, path, SDL_GetError());
+    }
+#else
+    (void)profiler;
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "hitch: %.1f ms frame, no phases with the profiler compiled out", (double)frame_us / 1000.0);
+#endif
 }
 
-void game_data_render(GameData* game_data, AssetData* asset_data, SDL_Renderer* renderer) {
-    SDL_SetRenderDrawColor(renderer, 100, 0, 0, 255);
-    SDL_RenderClear(renderer);
+//percentiles in ms, as a line of the summary
+int frame_times_format(char* text, size_t size, const char* name, const Histogram* histogram) {
+    return SDL_snprintf(text, size, "%-6s p50 %8.3f  p90 %8.3f  p95 %8.3f  p99 %8.3f  p99.9 %8.3f  max %8.3f  (%llu)\n",
+        name,
+        (double)histogram_percentile(histogram, 50.0) / 1000.0,
+        (double)histogram_percentile(histogram, 90.0) / 1000.0,
+        (double)histogram_percentile(histogram, 95.0) / 1000.0,
+        (double)histogram_percentile(histogram, 99.0) / 1000.0,
+        (double)histogram_percentile(histogram, 99.9) / 1000.0,
+        (double)histogram->max / 1000.0,
+        (unsigned long long)histogram->total
+    );
+}
 
-    world_clear(&game_data->world, renderer);
-
-    //bg ground
-    SDL_SetRenderTarget(renderer, game_data->world.bg_ground);
-    draw_tiled(renderer,asset_data->tex_ground, 0, 0, 40, 30);
-    //fg_ground
-    SDL_SetRenderTarget(renderer, game_data->world.fg_ground);
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_SetTextureColorMod(asset_data->tex_plants, 150, 150, 150);
-    vine_draw(&game_data->vine, renderer, asset_data->tex_plants, 21, (HF_Vec2f) { 0.f, 1.f });
-    SDL_SetTextureColorMod(asset_data->tex_plants, 255, 255, 255);
-    vine_draw(&game_data->vine, renderer, asset_data->tex_plants, 21, (HF_Vec2f) { 0.f, 0.f });
-    //bg sky
-    SDL_SetRenderTarget(renderer, game_data->world.bg_sky);
-    draw_tiled(renderer, asset_data->tex_water, 0, 0, 20, 20);
-    //fg_sky
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_SetRenderTarget(renderer, game_data->world.fg_sky);
-    SDL_SetTextureColorMod(asset_data->tex_plants, 150, 150, 150);
-    vine_draw(&game_data->vine, renderer, asset_data->tex_plants, 0, (HF_Vec2f) { 0.f, 1.f });
-    SDL_SetTextureColorMod(asset_data->tex_plants, 255, 255, 255);
-    vine_draw(&game_data->vine, renderer, asset_data->tex_plants, 0, (HF_Vec2f) { 0.f, 0.f });
+bool frame_times_write_summary(FrameTimes* frame_times, const char* path) {
+    SDL_RWops* rw = SDL_RWFromFile(path, "wb");
+    if(!rw) {
+        return false;
+    }
 
-    SDL_SetRenderTarget(renderer, NULL);
-    world_compose_texture(&game_data->world, renderer);
-    SDL_RenderCopy(renderer, game_data->world.composed_all, NULL, NULL);
-
-    switch (game_data->game_state) {
-    case GAME_STATE_Start: {
-        //desenhar trepadeira no meio da tela
-        int text_tile_w;
-        int text_tile_h;
-        SDL_QueryTexture(asset_data->text_start_title, NULL, NULL, &text_tile_w, &text_tile_h);
-
-        SDL_Rect dest_rect = {
-            WIN_W / 2 - text_tile_w / 2,
-            WIN_H / 2 - text_tile_h / 2,
-            text_tile_w,
-            text_tile_h,
-        };
-        SDL_SetTextureColorMod(asset_data->text_start_title, 0, 0, 0);
-        SDL_SetTextureAlphaMod(asset_data->text_start_title, 100);
-        SDL_RenderCopy(renderer, asset_data->text_start_title, NULL, &dest_rect);
-        dest_rect.x += 5;
-        dest_rect.y += 5;
-        SDL_SetTextureColorMod(asset_data->text_start_title, 150, 255, 150);
-        SDL_SetTextureAlphaMod(asset_data->text_start_title, 255);
-        SDL_RenderCopy(renderer, asset_data->text_start_title, NULL, &dest_rect);
-        break;
+    char text[1024];
+    int length = SDL_snprintf(text, sizeof(text), "ms, (count)\n");
+    length += frame_times_format(text + length, sizeof(text) - (size_t)length, "frame", &frame_times->frames);
+    length += frame_times_format(text + length, sizeof(text) - (size_t)length, "tick", &frame_times->ticks);
+    length += SDL_snprintf(text + length, sizeof(text) - (size_t)length, "hitches over %.1f ms: %d\n", frame_times->hitch_ms, frame_times->hitches);
+
+    bool ok = SDL_RWwrite(rw, text, (size_t)length, 1) == 1;
+    return SDL_RWclose(rw) == 0 && ok;
+}
+
+void frame_times_draw_overlay(FrameTimes* frame_times, SDL_Renderer* renderer, TextAtlas* atlas, int x, int y) {
+    if(!frame_times->overlay || !atlas->texture) {
+        return;
     }
-    case GAME_STATE_Play: {
-        if(!game_data->vine_go) {//render tutorial
-            int tex_w;
-            int tex_h;
-            SDL_QueryTexture(asset_data->tex_tuto, NULL, NULL, &tex_w, &tex_h);
-
-            SDL_Rect src_rect = {
-                0,
-                game_data->tuto_flash ? tex_h / 2 : 0,
-                tex_w,
-                tex_h / 2
-            };
-            SDL_Rect dest_rect = {
-                WIN_W / 2 - tex_w / 2,
-                WIN_H / 2 - tex_h / 4,
-                tex_w,
-                tex_h / 2
-            };
-            SDL_RenderCopy(renderer, asset_data->tex_tuto, &src_rect, &dest_rect);
+
+    const char* names[2] = { "frame", "tick" };
+    Histogram* histograms[2] = { &frame_times->frames, &frame_times->ticks };
+    const char* columns[4] = { "p50", "p95", "p99", "max" };
+    double percentiles[3] = { 50.0, 95.0, 99.0 };
+
+    int line_height = atlas->line_height;
+    int column_w = 4 * line_height;
+    SDL_Rect background = { x, y, 4 * line_height + 4 * column_w + line_height, 3 * line_height + line_height / 2 };
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &background);
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Color gray = { 180, 180, 180, 255 };
+    int name_x = x + line_height / 2;
+    int line_y = y + line_height / 4;
+    text_draw(atlas, renderer, "ms", name_x, line_y, gray);
+    for(int i = 0; i < 4; i++) {
+        text_draw_right(atlas, renderer, columns[i], name_x + 4 * line_height + (i + 1) * column_w, line_y, gray);
+    }
+
+    char number[32];
+    for(int row = 0; row < 2; row++) {
+        line_y += line_height;
+        text_draw(atlas, renderer, names[row], name_x, line_y, white);
+        for(int i = 0; i < 4; i++) {
+            Uint32 us = i < 3 ? histogram_percentile(histograms[row], percentiles[i]) : histograms[row]->max;
+            SDL_snprintf(number, sizeof(number), "%.2f", (double)us / 1000.0);
+            text_draw_right(atlas, renderer, number, name_x + 4 * line_height + (i + 1) * column_w, line_y, white);
         }
-        {//render score text
-            int text_score_w;
-            int text_score_h;
-            SDL_QueryTexture(asset_data->text_play_score, NULL, NULL, &text_score_w, &text_score_h);
+    }
+}
 
-            SDL_Rect dest_rect = {
-                20,
-                40 + text_score_h / 2,
-                text_score_w,
-                text_score_h,
-            };
-            SDL_RenderCopy(renderer, asset_data->text_play_score, NULL, &dest_rect);
+void log_compose_mode(World* world) {
+    SDL_Log(
+        "world compose: %s, %.1f MB of render targets",
+        world->compose_mode == WORLD_COMPOSE_MODE_SinglePass ? "single pass" : "layered",
+        (double)world_texture_memory(world) / (1024.0 * 1024.0)
+    );
+}
+
+//compares the state a replay ended in with the recorded one, logs either way
+bool replay_check_hash(Replay* replay, GameData* game_data) {
+    Uint64 hash = game_data_hash(game_data);
+    if(hash != replay->final_hash) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "replay mismatch after %u ticks: final state hash %016llx, recorded %016llx",
+            replay->tick_count, (unsigned long long)hash, (unsigned long long)replay->final_hash
+        );
+        return false;
+    }
+    SDL_Log("replay matches after %u ticks: final state hash %016llx", replay->tick_count, (unsigned long long)hash);
+    return true;
+}
+
+void replay_finish_recording(Replay* replay, GameData* game_data, const char* path) {
+    replay->final_hash = game_data_hash(game_data);
+    if(replay_save(replay, path)) {
+        SDL_Log("%u ticks recorded to %s (%u runs)", replay->tick_count, path, replay->run_count);
+    }
+    else {
+        SDL_Log("couldn't write the recording to %s: %s", path, SDL_GetError());
+    }
+}
+
+//steps the simulation with scripted input and no video or audio, for regression and balancing runs
+//with playback the inputs come from it instead and tick_count 0 plays all of it, recording keeps whatever was played
+int run_headless(long long tick_count, int tick_rate, Uint64 seed, Replay* playback, Replay* recording, const char* record_path) {
+    if(playback) {
+        seed = playback->seed;
+        tick_rate = playback->tick_rate;
+        tick_count = tick_count > 0 ? SDL_min(tick_count, (long long)playback->tick_count) : (long long)playback->tick_count;
+    }
+
+    static GameData game_data;
+    game_data_init(&game_data, seed);
+    game_data_reset(&game_data);
+
+    Timestep timestep;
+    timestep_init(&timestep, tick_rate, 1);
+    float tick_delta = playback ? playback->tick_delta : timestep.tick_delta;
+    if(recording) {
+        replay_init(recording, seed, tick_rate, tick_delta);
+    }
+
+    long long games = 0;
+    long long score_sum = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for(long long tick = 0; tick < tick_count; tick++) {
+        //starts right away and weaves left and right in long arcs
+        GameInput input = {
+            .vine_input = { .turn = (tick / 150) % 3 == 0 ? 1.f : ((tick / 150) % 3 == 1 ? -1.f : 0.f) },
+            .ok = game_data.game_state != GAME_STATE_Play || !game_data.vine_go,
+        };
+        if(playback) {
+            replay_next(playback, &input);
+        }
+        if(recording) {
+            replay_record(recording, input);
         }
-        {//render best score text
-            int text_best_score_w;
-            int text_best_score_h;
-            SDL_QueryTexture(asset_data->text_play_best_score, NULL, NULL, &text_best_score_w, &text_best_score_h);
 
-            SDL_Rect dest_rect = {
-                20,
-                80 + text_best_score_h / 2,
-                text_best_score_w,
-                text_best_score_h,
-            };
-            SDL_RenderCopy(renderer, asset_data->text_play_best_score, NULL, &dest_rect);
+        GameState prev_state = game_data.game_state;
+        int prev_score = game_data.score;
+        game_data_update(&game_data, input, tick_delta);
+        game_data.sound_count = 0;
+
+        if(prev_state == GAME_STATE_Play && game_data.game_state != GAME_STATE_Play) {
+            games++;
+            score_sum += prev_score;
         }
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
 
-        //draw top bar
-        {
-            SDL_Rect bar_rect = {
-                WIN_W / 2 - SPEEDBAR_W / 2,
-                20,
-                SPEEDBAR_W,
-                SPEEDBAR_H,
-            };
+    printf("headless: %lld ticks at %d Hz in %.3f s, %.0f ticks/s (%.0fx real time)\n",
+        tick_count, tick_rate, seconds,
+        (double)tick_count / seconds,
+        (double)tick_count / (double)tick_rate / seconds
+    );
+    printf("seed: %llu\n", (unsigned long long)seed);
+    printf("games: %lld, mean score: %.2f, best score: %d\n",
+        games, games > 0 ? (double)score_sum / (double)games : 0.0, game_data.best_score
+    );
 
-            float pct = game_data->vine_speed / MAX_SPEED;
-            SDL_Rect filled_rect = {
-                bar_rect.x,
-                bar_rect.y,
-                (int)(pct * (float)SPEEDBAR_W),
-                bar_rect.h,
-            };
+    bool matches = true;
+    if(playback && (Uint32)tick_count == playback->tick_count) {
+        matches = replay_check_hash(playback, &game_data);
+    }
+    if(recording) {
+        replay_finish_recording(recording, &game_data, record_path);
+    }
 
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(renderer, &bar_rect);
-            SDL_RenderFillRect(renderer, &filled_rect);
-        }
-        break;
+    game_data_deinit(&game_data);
+    return matches ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//how long after launch the first frame, the title screen and a playable game reached the screen
+typedef struct StartupPhases_s {
+    Uint64 launch;
+    bool first_frame;
+    bool title;
+    bool interactive;
+} StartupPhases;
+
+void startup_phases_log(StartupPhases* phases, const char* phase) {
+    double ms = (double)(SDL_GetPerformanceCounter() - phases->launch) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    SDL_Log("time to %s: %.1f ms", phase, ms);
+}
+
+void startup_phases_end_frame(StartupPhases* phases, AssetData* asset_data) {
+    if(!phases->first_frame) {
+        phases->first_frame = true;
+        startup_phases_log(phases, "first frame");
     }
-    default:
-        break;
+    if(!phases->title && asset_data->title_ready) {
+        phases->title = true;
+        startup_phases_log(phases, "title");
+    }
+    if(!phases->interactive && asset_data->ready) {
+        phases->interactive = true;
+        startup_phases_log(phases, "interactive");
     }
 }
 
+//widest batch kernels the cpu runs, or the named ones when it can run them too
+void select_batch_backend(const char* name) {
+    bool has_sse2 = SDL_HasSSE2();
+    bool has_avx2 = SDL_HasAVX2();
+    bool has_neon = SDL_HasNEON();
+    hf_batch_select_best(has_sse2, has_avx2, has_neon);
+
+    const char* backend_names[] = HF_BATCH_BACKEND_NAMES;
+    bool has[HF_BATCH_BACKEND_Count] = { true, has_sse2, has_avx2, has_neon };
+    for(int i = 0; name && i < HF_BATCH_BACKEND_Count; i++) {
+        if(SDL_strcmp(name, backend_names[i]) == 0 && !(has[i] && hf_batch_select((HF_BatchBackend)i))) {
+            SDL_Log("batch backend %s is not available here", name);
+        }
+    }
+    SDL_Log("batch backend: %s", backend_names[hf_batch_backend()]);
+}
+
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
-    srand((unsigned int)time(NULL));
+    StartupPhases startup_phases = { .launch = SDL_GetPerformanceCounter() };
+    bool full_redraw = false;
+    long long headless_ticks = -1;
+    WorldComposeMode compose_mode = WORLD_COMPOSE_MODE_SinglePass;
+    bool mask_antialias = true;
+    int tick_rate = TIMESTEP_DEFAULT_TICK_RATE;
+    int audio_buffer_frames = AUDIO_DEFAULT_BUFFER_FRAMES;
+    const char* batch_backend = NULL;
+    const char* trace_path = NULL;
+    const char* frame_stats_path = NULL;
+    double hitch_ms = FRAME_TIMES_DEFAULT_HITCH_MS;
+    Uint64 seed = 0;
+    bool seeded = false;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    bool unthrottled = false;
+    for(int i = 1; i < argc; i++) {
+        if(SDL_strcmp(argv[i], "--full-redraw") == 0) {
+            full_redraw = true;
+        }
+        if(SDL_strcmp(argv[i], "--layered-compose") == 0) {
+            compose_mode = WORLD_COMPOSE_MODE_Layered;
+        }
+        if(SDL_strcmp(argv[i], "--aliased-mask") == 0) {
+            mask_antialias = false;
+        }
+        if(SDL_strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tick_rate = SDL_atoi(argv[++i]);
+        }
+        if(SDL_strcmp(argv[i], "--low-latency-audio") == 0) {
+            audio_buffer_frames = AUDIO_LOW_LATENCY_BUFFER_FRAMES;
+        }
+        if(SDL_strcmp(argv[i], "--audio-buffer") == 0 && i + 1 < argc) {//frames, a power of two
+            audio_buffer_frames = SDL_atoi(argv[++i]);
+        }
+        if(SDL_strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {//scalar, sse2, avx2 or neon
+            batch_backend = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {//written at exit and with PROFILER_TRACE_KEY
+            trace_path = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) {//summary written at exit
+            frame_stats_path = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--hitch-ms") == 0 && i + 1 < argc) {//0 turns the captures off
+            hitch_ms = SDL_atof(argv[++i]);
+        }
+        if(SDL_strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {//same worlds and sounds on every run and platform
+            seed = SDL_strtoull(argv[++i], NULL, 0);
+            seeded = true;
+        }
+        if(SDL_strcmp(argv[i], "--record") == 0 && i + 1 < argc) {//every tick's input, written at exit
+            record_path = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {//plays a recording back instead of reading the devices
+            replay_path = argv[++i];
+        }
+        if(SDL_strcmp(argv[i], "--unthrottled") == 0) {//replays one tick per frame without vsync, as fast as it draws
+            unthrottled = true;
+        }
+        if(SDL_strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+            headless_ticks = SDL_strtoll(argv[++i], NULL, 10);
+        }
+    }
+    if(!seeded) {
+        seed = (Uint64)time(NULL);
+    }
+    select_batch_backend(batch_backend);
+
+    //one or the other, a recording of a replay would only be a copy of it
+    static Replay replay;
+    Replay* playback = NULL;
+    Replay* recording = NULL;
+    if(replay_path) {
+        if(!replay_load(&replay, replay_path)) {
+            SDL_Log("couldn't read the replay %s: %s", replay_path, SDL_GetError());
+            return EXIT_FAILURE;
+        }
+        playback = &replay;
+        seed = replay.seed;
+        tick_rate = replay.tick_rate;
+        SDL_Log("replaying %s: %u ticks at %d Hz, seed %llu", replay_path, replay.tick_count, replay.tick_rate, (unsigned long long)replay.seed);
+    }
+    else if(record_path) {
+        recording = &replay;
+    }
+
+    if(headless_ticks >= 0) {
+        int result = run_headless(headless_ticks, tick_rate > 0 ? tick_rate : TIMESTEP_DEFAULT_TICK_RATE, seed, playback, recording, record_path);
+        replay_free(&replay);
+        return result;
+    }
 
     if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER | SDL_INIT_GAMECONTROLLER)) {
         exit(EXIT_FAILURE);
     }
-    SDL_GameControllerAddMappingsFromFile("./assets/gamecontrollerdb.txt");
 
+    //only needed the first time, later launches read the decoded music from the cache
     Mix_Init(MIX_INIT_MP3);
-    Mix_OpenAudio(48000, AUDIO_S16SYS, 1, 2048);
-    Mix_AllocateChannels(20);
+    static Audio audio;//the mixer callback holds on to it
+    if(!audio_open(&audio, audio_buffer_frames > 0 ? audio_buffer_frames : AUDIO_DEFAULT_BUFFER_FRAMES)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "no audio: %s", Mix_GetError());
+    }
 
     TTF_Init();
 
@@ -541,70 +950,219 @@ int main(int argc, char* argv[]) {
         exit(EXIT_FAILURE);
     }
 
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    unthrottled = unthrottled && playback;//the live game keeps real time whatever the frame rate
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (unthrottled ? 0 : SDL_RENDERER_PRESENTVSYNC));
     if(!renderer) {
         exit(EXIT_FAILURE);
     }
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     //SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "2");
 
-    GameData game_data;
-    game_data_init(&game_data, renderer);
-    game_data_reset(&game_data, renderer);
+    static GameData game_data;//the vine grid is too big for the stack with long vines
+    static VineRender vine_render;//same for the mesh
+    game_data_init(&game_data, seed);
+    SDL_Log("seed %llu", (unsigned long long)seed);//to play the same worlds again with --seed
+    game_data.world.mask_antialias = mask_antialias;
+    game_data.world.compose_mode = compose_mode;
+    world_init_render(&game_data.world, renderer);
+    log_compose_mode(&game_data.world);
+    game_data_reset(&game_data);
 
     AssetData asset_data;
-    asset_data_init(&asset_data, renderer);
+    asset_data_init(&asset_data);
 
-    Mix_PlayMusic(asset_data.music_fast, 1000);
+    //mappings are only registered for the devices that show up, parsing the whole text db cost startup time
+    ControllerDb controller_db;
+    if(!controller_db_load(&controller_db, asset_loader_open(&asset_data.loader, "gamecontrollerdb.bin"))) {
+        SDL_Log("no controller db: %s", SDL_GetError());
+    }
+    controller_db_add_defaults(&controller_db);
 
     SDL_GameController* main_controller = NULL;
 
+    FrameCounters frame_counters;
+    frame_counters_init(&frame_counters, &audio);
+
+#ifdef PROFILER_ENABLED
+    static Profiler profiler_data;//the sample ring is too big for the stack
+    profiler_init(&profiler_data);
+    Profiler* profiler = &profiler_data;
+#else
+    Profiler* profiler = NULL;//the scopes compile to nothing and never look at it
+#endif
+
+    //captures and the summary go next to the music cache
+    static FrameTimes frame_times;
+    frame_times_init(&frame_times, hitch_ms, asset_data.cache_dir);
+
+    Timestep timestep;
+    timestep_init(&timestep, tick_rate, TIMESTEP_DEFAULT_MAX_TICKS);
+    bool pending_ok = false;//pressed on a frame that ran no tick, handed to the next one
+    float tick_delta = playback ? playback->tick_delta : timestep.tick_delta;
+    if(recording) {
+        replay_init(recording, seed, tick_rate > 0 ? tick_rate : TIMESTEP_DEFAULT_TICK_RATE, tick_delta);
+    }
+
     bool quit = false;
-    Uint32 prev_ticks = SDL_GetTicks();
     while(!quit) {
-        {//logic update
-            //frame variables
-            GameInput game_input = {
-                .vine_input = {
-                    .turn = 0.f,
-                },
-                .ok = false
-            };
-
-            SDL_Event e;
-            while(SDL_PollEvent(&e)) {
-                if(e.type == SDL_QUIT) {
-                    quit = true;
+        PROFILER_SCOPE(profiler, PROFILER_PHASE_Frame) {
+            {//logic update
+                //frame variables
+                GameInput game_input = {
+                    .vine_input = {
+                        .turn = 0.f,
+                    },
+                    .ok = false
+                };
+
+                PROFILER_SCOPE(profiler, PROFILER_PHASE_Events) {
+                    SDL_Event e;
+                    while(SDL_PollEvent(&e)) {
+                        if(e.type == SDL_QUIT) {
+                            quit = true;
+                        }
+                        if(e.type == SDL_RENDER_TARGETS_RESET) {
+                            world_invalidate(&game_data.world);
+                        }
+                        if(e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F2 && !e.key.repeat) {//compare compose modes live
+                            World* world = &game_data.world;
+                            world_set_compose_mode(
+                                world,
+                                renderer,
+                                world->compose_mode == WORLD_COMPOSE_MODE_SinglePass ? WORLD_COMPOSE_MODE_Layered : WORLD_COMPOSE_MODE_SinglePass
+                            );
+                            log_compose_mode(world);
+                        }
+#ifdef PROFILER_ENABLED
+                        if(e.type == SDL_KEYDOWN && e.key.keysym.sym == PROFILER_OVERLAY_KEY && !e.key.repeat) {
+                            profiler->overlay = !profiler->overlay;
+                        }
+                        if(e.type == SDL_KEYDOWN && e.key.keysym.sym == PROFILER_TRACE_KEY && !e.key.repeat) {
+                            const char* path = trace_path ? trace_path : PROFILER_DEFAULT_TRACE_PATH;
+                            if(profiler_write_trace(profiler, path)) {
+                                SDL_Log("trace written to %s", path);
+                            }
+                            else {
+                                SDL_Log("couldn't write the trace to %s: %s", path, SDL_GetError());
+                            }
+                        }
+#endif
+                        if(e.type == SDL_KEYDOWN && e.key.keysym.sym == FRAME_TIMES_OVERLAY_KEY && !e.key.repeat) {
+                            frame_times.overlay = !frame_times.overlay;
+                        }
+                        if(e.type == SDL_JOYDEVICEADDED) {//also sent for the devices already plugged in at startup
+                            controller_db_add_device(&controller_db, e.jdevice.which);
+                            main_controller = SDL_GameControllerOpen(e.jdevice.which);
+                        }
+                        if(e.type == SDL_JOYDEVICEREMOVED) {
+                            SDL_GameControllerClose(SDL_GameControllerFromInstanceID(e.jdevice.which));
+                            main_controller = NULL;
+                        }
+                        game_input_process_event(&game_input, e);
+                    }
+
+                    const Uint8* keyboard = SDL_GetKeyboardState(NULL);
+                    game_input_process_keyboard(&game_input, keyboard);
+                    game_input_process_controller(&game_input, main_controller);
                 }
-                if(e.type == SDL_JOYDEVICEADDED) {
-                    main_controller = SDL_GameControllerOpen(e.jdevice.which);
+
+                //held input repeats on every tick, presses only reach the first one
+                pending_ok = (pending_ok || game_input.ok) && asset_data.ready;//no starting before everything is loaded
+                int ticks = timestep_begin_frame(&timestep);
+                if(playback) {
+                    //waits for the assets like the player did, the ticks are only delayed
+                    ticks = !asset_data.ready ? 0 : (unthrottled ? 1 : ticks);
                 }
-                if(e.type == SDL_JOYDEVICEREMOVED) {
-                    SDL_GameControllerClose(SDL_GameControllerFromInstanceID(e.jdevice.which));
-                    main_controller = NULL;
+                PROFILER_SCOPE(profiler, PROFILER_PHASE_Update) {
+                    for(int i = 0; i < ticks; i++) {
+                        if(playback) {
+                            if(!replay_next(playback, &game_input)) {
+                                quit = true;
+                                break;
+                            }
+                        }
+                        else {
+                            game_input.ok = pending_ok;
+                            pending_ok = false;
+                        }
+                        if(recording) {
+                            replay_record(recording, game_input);
+                        }
+                        Uint64 tick_start = SDL_GetPerformanceCounter();
+                        game_data_update(&game_data, game_input, tick_delta);
+                        frame_times_record_tick(&frame_times, SDL_GetPerformanceCounter() - tick_start);
+                    }
                 }
-                game_input_process_event(&game_input, e);
+                asset_data_play_sounds(&asset_data, &game_data, &audio);
+                vine_interpolate_tip(&game_data.vine, &vine_render, unthrottled ? 1.f : timestep_alpha(&timestep));
             }
 
-            const Uint8* keyboard = SDL_GetKeyboardState(NULL);
-            game_input_process_keyboard(&game_input, keyboard);
-            game_input_process_controller(&game_input, main_controller);
+            //drawing loop
+            asset_data_poll(&asset_data, renderer);
+            if(asset_data.title_ready) {
+                PROFILER_SCOPE(profiler, PROFILER_PHASE_Tiles) {
+                    world_set_tiles(&game_data.world, renderer, asset_data.tex_ground, asset_data.tex_water);
+                }
+                game_data_render(&game_data, &vine_render, &asset_data, renderer, !full_redraw, profiler);
+#ifdef PROFILER_ENABLED
+                profiler_draw_overlay(profiler, renderer, &asset_data.atlas_score, 20, 120);
+#endif
+                frame_times_draw_overlay(&frame_times, renderer, &asset_data.atlas_score, 20, 480);
+            }
+            else {//the first frames only show that the game is alive
+                SDL_SetRenderDrawColor(renderer, 100, 0, 0, 255);
+                SDL_RenderClear(renderer);
+            }
 
-            Uint32 new_ticks = SDL_GetTicks();
-            float delta = (float)(new_ticks - prev_ticks) / 1000.f;
-            prev_ticks = new_ticks;
+            PROFILER_SCOPE(profiler, PROFILER_PHASE_Present) {
+                SDL_RenderPresent(renderer);
+            }
+        }
+        startup_phases_end_frame(&startup_phases, &asset_data);
+        frame_counters_end_frame(&frame_counters, &game_data);
+#ifdef PROFILER_ENABLED
+        profiler_end_frame(profiler);
+#endif
+        frame_times_end_frame(&frame_times, profiler);
+    }
 
-            game_data_update(&game_data, &asset_data, game_input, delta, renderer);
+    if(trace_path) {
+#ifdef PROFILER_ENABLED
+        if(!profiler_write_trace(profiler, trace_path)) {
+            SDL_Log("couldn't write the trace to %s: %s", trace_path, SDL_GetError());
         }
+#else
+        SDL_Log("no trace, the profiler is compiled out of this build (see TREPADEIRA_PROFILER)");
+#endif
+    }
 
-        //drawing loop
-        game_data_render(&game_data, &asset_data, renderer);
+    if(playback) {
+        if(playback->cursor >= playback->run_count) {
+            replay_check_hash(playback, &game_data);
+        }
+        else {
+            SDL_Log("replay stopped before its end, no hash to compare");
+        }
+    }
+    if(recording) {
+        replay_finish_recording(recording, &game_data, record_path);
+    }
+    replay_free(&replay);
 
-        SDL_RenderPresent(renderer);
+    char default_stats_path[512];
+    SDL_snprintf(default_stats_path, sizeof(default_stats_path), "%sframe_stats.txt", frame_times.output_dir);
+    frame_stats_path = frame_stats_path ? frame_stats_path : default_stats_path;
+    if(frame_times_write_summary(&frame_times, frame_stats_path)) {
+        SDL_Log("frame times written to %s", frame_stats_path);
+    }
+    else {
+        SDL_Log("couldn't write the frame times to %s: %s", frame_stats_path, SDL_GetError());
     }
 
     game_data_deinit(&game_data);
+    audio_close(&audio);//queued sounds point at chunks freed below
     asset_data_deinit(&asset_data);
+    controller_db_free(&controller_db);
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -0,0 +1,155 @@
+#include "pak.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static void* pak__map(Pak* pak, const char* path) {
+#ifdef _WIN32
+    pak->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(pak->file == INVALID_HANDLE_VALUE) {
+        pak->file = NULL;
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(pak->file, &size) || size.QuadPart == 0) {
+        return NULL;
+    }
+    pak->size = (size_t)size.QuadPart;
+
+    pak->mapping = CreateFileMappingA(pak->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(!pak->mapping) {
+        return NULL;
+    }
+    return MapViewOfFile(pak->mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    pak->fd = open(path, O_RDONLY);
+    if(pak->fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    if(fstat(pak->fd, &info) != 0 || info.st_size <= 0) {
+        return NULL;
+    }
+    pak->size = (size_t)info.st_size;
+
+    void* data = mmap(NULL, pak->size, PROT_READ, MAP_PRIVATE, pak->fd, 0);
+    return data == MAP_FAILED ? NULL : data;
+#endif
+}
+
+//entries must fit in the file, end inside it, be zero terminated and sorted, pak_find bisects them unchecked
+static bool pak__validate(Pak* pak) {
+    if(pak->size < sizeof(PakHeader)) {
+        return false;
+    }
+    const PakHeader* header = (const PakHeader*)pak->data;
+    if(SDL_SwapLE32(header->magic) != PAK_MAGIC || SDL_SwapLE32(header->version) != PAK_VERSION) {
+        return false;
+    }
+
+    pak->entry_count = SDL_SwapLE32(header->entry_count);
+    pak->entries = (const PakEntry*)(pak->data + sizeof(PakHeader));
+    if(pak->entry_count > (pak->size - sizeof(PakHeader)) / sizeof(PakEntry)) {
+        return false;
+    }
+
+    for(Uint32 i = 0; i < pak->entry_count; i++) {
+        const PakEntry* entry = &pak->entries[i];
+        Uint64 end = (Uint64)SDL_SwapLE32(entry->offset) + SDL_SwapLE32(entry->size);
+        if(end > pak->size || entry->name[PAK_NAME_SIZE - 1] != '\0') {
+            return false;
+        }
+        if(i > 0 && SDL_strcmp(pak->entries[i - 1].name, entry->name) >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool pak_open(Pak* pak, const char* path) {
+    *pak = (Pak) { 0 };
+#ifndef _WIN32
+    pak->fd = -1;
+#endif
+
+    pak->data = pak__map(pak, path);
+    if(!pak->data || !pak__validate(pak)) {
+        if(pak->data) {
+            SDL_SetError("%s is not a valid archive", path);
+        }
+        pak_close(pak);
+        return false;
+    }
+    return true;
+}
+
+void pak_close(Pak* pak) {
+#ifdef _WIN32
+    if(pak->data) {
+        UnmapViewOfFile(pak->data);
+    }
+    if(pak->mapping) {
+        CloseHandle(pak->mapping);
+    }
+    if(pak->file) {
+        CloseHandle(pak->file);
+    }
+#else
+    if(pak->data) {
+        munmap((void*)pak->data, pak->size);
+    }
+    if(pak->fd >= 0) {
+        close(pak->fd);
+    }
+#endif
+    *pak = (Pak) { 0 };
+#ifndef _WIN32
+    pak->fd = -1;
+#endif
+}
+
+const void* pak_find(const Pak* pak, const char* name, size_t* size) {
+    if(!pak->data) {
+        return NULL;
+    }
+
+    //entries are sorted by name
+    Uint32 low = 0;
+    Uint32 high = pak->entry_count;
+    while(low < high) {
+        Uint32 middle = low + (high - low) / 2;
+        int order = SDL_strcmp(pak->entries[middle].name, name);
+        if(order == 0) {
+            if(size) {
+                *size = SDL_SwapLE32(pak->entries[middle].size);
+            }
+            return pak->data + SDL_SwapLE32(pak->entries[middle].offset);
+        }
+        if(order < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+SDL_RWops* pak_open_rw(const Pak* pak, const char* name) {
+    size_t size;
+    const void* data = pak_find(pak, name, &size);
+    if(!data) {
+        SDL_SetError("%s is not in the archive", name);
+        return NULL;
+    }
+    return SDL_RWFromConstMem(data, (int)size);
+}
@@ -0,0 +1,217 @@
+#include "profiler.h"
+
+void profiler_init(Profiler* profiler) {
+    SDL_memset(profiler, 0, sizeof(*profiler));
+    profiler->window_start = SDL_GetPerformanceCounter();
+}
+
+ProfilerScope profiler_begin(Profiler* profiler, ProfilerPhase phase) {
+    profiler->depth++;
+    return (ProfilerScope) {
+        .profiler = profiler,
+        .phase = phase,
+        .start = SDL_GetPerformanceCounter(),
+        .done = false,
+    };
+}
+
+void profiler_end(ProfilerScope* scope) {
+    Uint64 end = SDL_GetPerformanceCounter();
+    Profiler* profiler = scope->profiler;
+    profiler->depth--;
+
+    int index = SDL_AtomicGet(&profiler->written);
+    profiler->samples[index & (PROFILER_CAPACITY - 1)] = (ProfilerSample) {
+        .start = scope->start,
+        .end = end,
+        .frame = profiler->frame,
+        .phase = (Uint8)scope->phase,
+        .depth = (Uint8)profiler->depth,
+    };
+    SDL_AtomicSet(&profiler->written, index + 1);//full barrier, readers never see the index before the sample
+    scope->done = true;
+}
+
+void profiler_end_frame(Profiler* profiler) {
+    int written = SDL_AtomicGet(&profiler->written);
+    int first = written - profiler->aggregated > PROFILER_CAPACITY ? written - PROFILER_CAPACITY : profiler->aggregated;
+    for(int i = first; i < written; i++) {
+        ProfilerSample sample = profiler->samples[i & (PROFILER_CAPACITY - 1)];
+        profiler->frame_ticks[sample.phase] += sample.end - sample.start;
+    }
+    profiler->aggregated = written;
+
+    for(int i = 0; i < PROFILER_PHASE_Count; i++) {
+        profiler->window_ticks[i] += profiler->frame_ticks[i];
+        profiler->window_max_ticks[i] = SDL_max(profiler->window_max_ticks[i], profiler->frame_ticks[i]);
+        profiler->frame_ticks[i] = 0;
+    }
+    profiler->window_frames++;
+    profiler->frame++;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    if(now - profiler->window_start < frequency) {
+        return;
+    }
+    for(int i = 0; i < PROFILER_PHASE_Count; i++) {
+        profiler->average_ms[i] = (double)profiler->window_ticks[i] * 1000.0 / (double)frequency / (double)profiler->window_frames;
+        profiler->max_ms[i] = (double)profiler->window_max_ticks[i] * 1000.0 / (double)frequency;
+        profiler->window_ticks[i] = 0;
+        profiler->window_max_ticks[i] = 0;
+    }
+    profiler->window_frames = 0;
+    profiler->window_start = now;
+}
+
+int profiler_copy(Profiler* profiler, ProfilerSample* samples, int count) {
+    int written = SDL_AtomicGet(&profiler->written);
+    count = SDL_min(count, SDL_min(written, PROFILER_CAPACITY));
+    int first = written - count;
+    for(int i = 0; i < count; i++) {
+        samples[i] = profiler->samples[(first + i) & (PROFILER_CAPACITY - 1)];
+    }
+
+    //the writer may have lapped the oldest ones while they were copied, slot k is rewritten once written reaches k + capacity
+    int torn = SDL_AtomicGet(&profiler->written) + 1 - PROFILER_CAPACITY - first;
+    if(torn <= 0) {
+        return count;
+    }
+    if(torn >= count) {
+        return 0;
+    }
+    SDL_memmove(samples, samples + torn, sizeof(ProfilerSample) * (size_t)(count - torn));
+    return count - torn;
+}
+
+bool profiler_write_trace(Profiler* profiler, const char* path) {
+    ProfilerSample* samples = SDL_malloc(sizeof(ProfilerSample) * PROFILER_CAPACITY);
+    if(!samples) {
+        return false;
+    }
+    int count = profiler_copy(profiler, samples, PROFILER_CAPACITY);
+
+    SDL_RWops* rw = SDL_RWFromFile(path, "wb");
+    if(!rw) {
+        SDL_free(samples);
+        return false;
+    }
+
+    //complete events in microseconds from the oldest sample, one thread, nesting comes from the times
+    const char* phase_names[] = PROFILER_PHASE_NAMES;
+    double us_per_tick = 1e6 / (double)SDL_GetPerformanceFrequency();
+    Uint64 base = count > 0 ? samples[0].start : 0;
+    for(int i = 1; i < count; i++) {
+        base = SDL_min(base, samples[i].start);
+    }
+
+    char line[256];
+    bool ok = SDL_RWwrite(rw, "{\"traceEvents\":[\n", 17, 1) == 1;
+    for(int i = 0; i < count && ok; i++) {
+        ProfilerSample sample = samples[i];
+        int length = SDL_snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}%s\n",
+            phase_names[sample.phase],
+            (double)(sample.start - base) * us_per_tick,
+            (double)(sample.end - sample.start) * us_per_tick,
+            sample.frame,
+            i + 1 < count ? "," : ""
+        );
+        ok = SDL_RWwrite(rw, line, (size_t)length, 1) == 1;
+    }
+    ok = ok && SDL_RWwrite(rw, "]}\n", 3, 1) == 1;
+
+    SDL_free(samples);
+    return SDL_RWclose(rw) == 0 && ok;
+}
+
+bool profiler_write_frames(Profiler* profiler, const char* path, int frame_count) {
+    ProfilerSample* samples = SDL_malloc(sizeof(ProfilerSample) * PROFILER_CAPACITY);
+    double* frame_ms = SDL_calloc((size_t)frame_count * PROFILER_PHASE_Count, sizeof(double));
+    SDL_RWops* rw = samples && frame_ms ? SDL_RWFromFile(path, "wb") : NULL;
+    if(!rw) {
+        SDL_free(samples);
+        SDL_free(frame_ms);
+        return false;
+    }
+
+    //profiler->frame is the one still running, its samples are left out
+    int count = profiler_copy(profiler, samples, PROFILER_CAPACITY);
+    int first_frame = profiler->frame - frame_count;
+    double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    for(int i = 0; i < count; i++) {
+        int row = samples[i].frame - first_frame;
+        if(row >= 0 && row < frame_count) {
+            frame_ms[row * PROFILER_PHASE_Count + samples[i].phase] += (double)(samples[i].end - samples[i].start) * ms_per_tick;
+        }
+    }
+
+    const char* phase_names[] = PROFILER_PHASE_NAMES;
+    char line[512];
+    int length = SDL_snprintf(line, sizeof(line), "frame");
+    for(int i = 0; i < PROFILER_PHASE_Count; i++) {
+        length += SDL_snprintf(line + length, sizeof(line) - (size_t)length, ",%s", phase_names[i]);
+    }
+    bool ok = SDL_RWwrite(rw, line, (size_t)length, 1) == 1 && SDL_RWwrite(rw, "\n", 1, 1) == 1;
+    for(int row = 0; row < frame_count && ok; row++) {
+        if(first_frame + row < 0) {
+            continue;
+        }
+        length = SDL_snprintf(line, sizeof(line), "%d", first_frame + row);
+        for(int i = 0; i < PROFILER_PHASE_Count; i++) {
+            length += SDL_snprintf(line + length, sizeof(line) - (size_t)length, ",%.3f", frame_ms[row * PROFILER_PHASE_Count + i]);
+        }
+        ok = SDL_RWwrite(rw, line, (size_t)length, 1) == 1 && SDL_RWwrite(rw, "\n", 1, 1) == 1;
+    }
+
+    SDL_free(samples);
+    SDL_free(frame_ms);
+    return SDL_RWclose(rw) == 0 && ok;
+}
+
+void profiler_draw_overlay(Profiler* profiler, SDL_Renderer* renderer, TextAtlas* atlas, int x, int y) {
+    if(!profiler->overlay || !atlas->texture) {
+        return;
+    }
+
+    //phase name, average and max ms per frame, then the average as a share of the frame
+    const char* phase_names[] = PROFILER_PHASE_NAMES;
+    int line_height = atlas->line_height;
+    int name_x = x + line_height / 2;
+    int average_x = name_x + 10 * line_height;
+    int max_x = average_x + 4 * line_height;
+    int bar_x = max_x + line_height;
+    int bar_w = 8 * line_height;
+    SDL_Rect background = { x, y, bar_x + bar_w + line_height / 2 - x, (PROFILER_PHASE_Count + 1) * line_height + line_height / 2 };
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &background);
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Color gray = { 180, 180, 180, 255 };
+    int line_y = y + line_height / 4;
+    text_draw(atlas, renderer, "ms/frame", name_x, line_y, gray);
+    text_draw_right(atlas, renderer, "avg", average_x, line_y, gray);
+    text_draw_right(atlas, renderer, "max", max_x, line_y, gray);
+
+    double frame_ms = profiler->average_ms[PROFILER_PHASE_Frame];
+    char number[32];
+    for(int i = 0; i < PROFILER_PHASE_Count; i++) {
+        line_y += line_height;
+        text_draw(atlas, renderer, phase_names[i], name_x, line_y, white);
+        SDL_snprintf(number, sizeof(number), "%.3f", profiler->average_ms[i]);
+        text_draw_right(atlas, renderer, number, average_x, line_y, white);
+        SDL_snprintf(number, sizeof(number), "%.3f", profiler->max_ms[i]);
+        text_draw_right(atlas, renderer, number, max_x, line_y, white);
+
+        if(frame_ms > 0.0) {
+            SDL_Rect bar = {
+                bar_x,
+                line_y + line_height / 4,
+                (int)((double)bar_w * SDL_min(profiler->average_ms[i] / frame_ms, 1.0)),
+                line_height / 2,
+            };
+            SDL_SetRenderDrawColor(renderer, 150, 255, 150, 255);
+            SDL_RenderFillRect(renderer, &bar);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include "replay.h"
+
+void replay_init(Replay* replay, Uint64 seed, int tick_rate, float tick_delta) {
+    *replay = (Replay) {
+        .seed = seed,
+        .tick_rate = tick_rate,
+        .tick_delta = tick_delta,
+    };
+}
+
+void replay_free(Replay* replay) {
+    SDL_free(replay->runs);
+    replay->runs = NULL;
+    replay->run_count = 0;
+    replay->run_capacity = 0;
+}
+
+bool replay_record(Replay* replay, GameInput input) {
+    ReplayRun run = {
+        .turn = (Sint8)SDL_clamp(input.vine_input.turn, -127.f, 127.f),
+        .ok = input.ok,
+        .count = 1,
+    };
+
+    if(replay->run_count > 0) {
+        ReplayRun* last = &replay->runs[replay->run_count - 1];
+        if(last->turn == run.turn && last->ok == run.ok && last->count < SDL_MAX_UINT16) {
+            last->count++;
+            replay->tick_count++;
+            return true;
+        }
+    }
+
+    if(replay->run_count == replay->run_capacity) {
+        Uint32 capacity = replay->run_capacity > 0 ? replay->run_capacity * 2 : 1024;
+        ReplayRun* runs = SDL_realloc(replay->runs, sizeof(ReplayRun) * capacity);
+        if(!runs) {
+            return false;
+        }
+        replay->runs = runs;
+        replay->run_capacity = capacity;
+    }
+    replay->runs[replay->run_count] = run;
+    replay->run_count++;
+    replay->tick_count++;
+    return true;
+}
+
+bool replay_next(Replay* replay, GameInput* input) {
+    if(replay->cursor >= replay->run_count) {
+        return false;
+    }
+
+    ReplayRun run = replay->runs[replay->cursor];
+    *input = (GameInput) {
+        .vine_input = { .turn = (float)run.turn },
+        .ok = run.ok != 0,
+    };
+    replay->cursor_tick++;
+    if(replay->cursor_tick >= run.count) {
+        replay->cursor++;
+        replay->cursor_tick = 0;
+    }
+    return true;
+}
+
+static Uint32 replay__float_bits(float value) {
+    Uint32 bits;
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float replay__bits_float(Uint32 bits) {
+    float value;
+    SDL_memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool replay_save(const Replay* replay, const char* path) {
+    SDL_RWops* rw = SDL_RWFromFile(path, "wb");
+    if(!rw) {
+        return false;
+    }
+
+    ReplayHeader header = {
+        .magic = SDL_SwapLE32(REPLAY_MAGIC),
+        .version = SDL_SwapLE32(REPLAY_VERSION),
+        .seed = SDL_SwapLE64(replay->seed),
+        .tick_rate = SDL_SwapLE32((Uint32)replay->tick_rate),
+        .tick_delta = SDL_SwapLE32(replay__float_bits(replay->tick_delta)),
+        .tick_count = SDL_SwapLE32(replay->tick_count),
+        .run_count = SDL_SwapLE32(replay->run_count),
+        .final_hash = SDL_SwapLE64(replay->final_hash),
+    };
+    bool ok = SDL_RWwrite(rw, &header, sizeof(header), 1) == 1;
+    for(Uint32 i = 0; i < replay->run_count && ok; i++) {
+        ReplayRun run = replay->runs[i];
+        run.count = SDL_SwapLE16(run.count);
+        ok = SDL_RWwrite(rw, &run, sizeof(run), 1) == 1;
+    }
+    return SDL_RWclose(rw) == 0 && ok;
+}
+
+bool replay_load(Replay* replay, const char* path) {
+    replay_init(replay, 0, 0, 0.f);
+    SDL_RWops* rw = SDL_RWFromFile(path, "rb");
+    if(!rw) {
+        return false;
+    }
+
+    size_t size;
+    Uint8* data = SDL_LoadFile_RW(rw, &size, 1);
+    if(!data) {
+        return false;
+    }
+
+    //runs must fill the file exactly and none may be empty, so their counts add up to the ticks that were recorded
+    ReplayHeader header;
+    bool valid = size >= sizeof(header);
+    if(valid) {
+        SDL_memcpy(&header, data, sizeof(header));
+        valid = SDL_SwapLE32(header.magic) == REPLAY_MAGIC
+            && SDL_SwapLE32(header.version) == REPLAY_VERSION
+            && SDL_SwapLE32(header.run_count) == (size - sizeof(header)) / sizeof(ReplayRun)
+            && (size - sizeof(header)) % sizeof(ReplayRun) == 0
+            && SDL_SwapLE32(header.tick_rate) > 0;
+    }
+    Uint32 run_count = valid ? SDL_SwapLE32(header.run_count) : 0;
+    ReplayRun* runs = valid && run_count > 0 ? SDL_malloc(sizeof(ReplayRun) * run_count) : NULL;
+    Uint32 tick_count = 0;
+    for(Uint32 i = 0; i < run_count && runs; i++) {
+        SDL_memcpy(&runs[i], data + sizeof(header) + sizeof(ReplayRun) * i, sizeof(ReplayRun));
+        runs[i].count = SDL_SwapLE16(runs[i].count);
+        valid = valid && runs[i].count > 0;
+        tick_count += runs[i].count;
+    }
+    valid = valid && (run_count == 0 || runs) && tick_count == SDL_SwapLE32(header.tick_count);
+    SDL_free(data);
+    if(!valid) {
+        SDL_free(runs);
+        SDL_SetError("not a valid replay");
+        return false;
+    }
+
+    replay_init(replay, SDL_SwapLE64(header.seed), (int)SDL_SwapLE32(header.tick_rate), replay__bits_float(SDL_SwapLE32(header.tick_delta)));
+    replay->tick_count = tick_count;
+    replay->final_hash = SDL_SwapLE64(header.final_hash);
+    replay->runs = runs;
+    replay->run_count = run_count;
+    replay->run_capacity = run_count;
+    return true;
+}
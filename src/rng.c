@@ -0,0 +1,53 @@
+#include "rng.h"
+
+static Uint64 rng__splitmix64(Uint64* state) {
+    Uint64 z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static Uint32 rng__rotl(Uint32 x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+void rng_seed(Rng* rng, Uint64 seed) {
+    //splitmix64 never gives an all zero state, the one xoshiro can't leave
+    for(int i = 0; i < 4; i += 2) {
+        Uint64 z = rng__splitmix64(&seed);
+        rng->state[i] = (Uint32)z;
+        rng->state[i + 1] = (Uint32)(z >> 32);
+    }
+}
+
+Uint32 rng_next(Rng* rng) {
+    Uint32* s = rng->state;
+    Uint32 result = rng__rotl(s[1] * 5, 7) * 9;
+    Uint32 t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng__rotl(s[3], 11);
+
+    return result;
+}
+
+int rng_range(Rng* rng, int bound) {
+    //Lemire's multiply and shift, the few low products that would favor some values are drawn again
+    Uint32 range = (Uint32)bound;
+    Uint64 product = (Uint64)rng_next(rng) * range;
+    if((Uint32)product < range) {
+        Uint32 threshold = (0u - range) % range;
+        while((Uint32)product < threshold) {
+            product = (Uint64)rng_next(rng) * range;
+        }
+    }
+    return (int)(product >> 32);
+}
+
+float rng_float(Rng* rng) {
+    return (float)(rng_next(rng) >> 8) * (1.f / 16777216.f);
+}
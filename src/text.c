@@ -0,0 +1,124 @@
+#include "text.h"
+
+bool text_atlas_init(TextAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font) {
+    *atlas = (TextAtlas) { 0 };
+    if(!font) {
+        return false;
+    }
+    atlas->line_height = TTF_FontHeight(font);
+
+    //same white glyphs TTF_RenderText_Solid gives, packed in rows
+    SDL_Surface* glyph_surfaces[TEXT_GLYPH_COUNT];
+    int pen_x = 0;
+    int pen_y = 0;
+    for(int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16)(TEXT_FIRST_GLYPH + i);
+        glyph_surfaces[i] = TTF_RenderGlyph_Solid(font, ch, (SDL_Color) { 255, 255, 255, 255 });
+
+        int advance = 0;
+        TTF_GlyphMetrics(font, ch, NULL, NULL, NULL, NULL, &advance);
+        int glyph_w = glyph_surfaces[i] ? glyph_surfaces[i]->w : 0;
+        if(pen_x + glyph_w > TEXT_ATLAS_W) {
+            pen_x = 0;
+            pen_y += atlas->line_height + 1;
+        }
+
+        atlas->glyphs[i] = (TextGlyph) {
+            .rect = { pen_x, pen_y, glyph_w, atlas->line_height },
+            .advance = advance,
+        };
+        pen_x += glyph_w + 1;
+    }
+    atlas->texture_w = TEXT_ATLAS_W;
+    atlas->texture_h = pen_y + atlas->line_height;
+
+    SDL_Surface* atlas_surface = SDL_CreateRGBSurfaceWithFormat(0, atlas->texture_w, atlas->texture_h, 32, SDL_PIXELFORMAT_ARGB8888);
+    if(atlas_surface) {
+        SDL_FillRect(atlas_surface, NULL, 0);
+        for(int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+            if(glyph_surfaces[i]) {
+                SDL_Rect dest = atlas->glyphs[i].rect;
+                SDL_BlitSurface(glyph_surfaces[i], NULL, atlas_surface, &dest);
+            }
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, atlas_surface);
+        SDL_FreeSurface(atlas_surface);
+    }
+
+    for(int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        SDL_FreeSurface(glyph_surfaces[i]);
+    }
+    return atlas->texture != NULL;
+}
+
+void text_atlas_deinit(TextAtlas* atlas) {
+    SDL_DestroyTexture(atlas->texture);
+    atlas->texture = NULL;
+}
+
+static TextGlyph* text__glyph(TextAtlas* atlas, char ch) {
+    if(ch < TEXT_FIRST_GLYPH || ch > TEXT_LAST_GLYPH) {
+        ch = '?';
+    }
+    return &atlas->glyphs[ch - TEXT_FIRST_GLYPH];
+}
+
+int text_width(TextAtlas* atlas, const char* text) {
+    int width = 0;
+    for(int i = 0; text[i] && i < TEXT_MAX_QUADS; i++) {
+        width += text__glyph(atlas, text[i])->advance;
+    }
+    return width;
+}
+
+void text_draw(TextAtlas* atlas, SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
+    if(!atlas->texture) {
+        return;
+    }
+
+    SDL_Vertex vertices[TEXT_MAX_QUADS * 4];
+    int indices[TEXT_MAX_QUADS * 6];
+    int quad_count = 0;
+
+    float inv_w = 1.f / (float)atlas->texture_w;
+    float inv_h = 1.f / (float)atlas->texture_h;
+    float pen_x = (float)x;
+    for(int i = 0; text[i] && quad_count < TEXT_MAX_QUADS; i++) {
+        TextGlyph* glyph = text__glyph(atlas, text[i]);
+        if(glyph->rect.w > 0) {
+            float left = pen_x;
+            float top = (float)y;
+            float right = left + (float)glyph->rect.w;
+            float bottom = top + (float)glyph->rect.h;
+            float u0 = (float)glyph->rect.x * inv_w;
+            float v0 = (float)glyph->rect.y * inv_h;
+            float u1 = (float)(glyph->rect.x + glyph->rect.w) * inv_w;
+            float v1 = (float)(glyph->rect.y + glyph->rect.h) * inv_h;
+
+            SDL_Vertex* quad = &vertices[quad_count * 4];
+            quad[0] = (SDL_Vertex) { { left, top }, color, { u0, v0 } };
+            quad[1] = (SDL_Vertex) { { right, top }, color, { u1, v0 } };
+            quad[2] = (SDL_Vertex) { { right, bottom }, color, { u1, v1 } };
+            quad[3] = (SDL_Vertex) { { left, bottom }, color, { u0, v1 } };
+
+            int* quad_indices = &indices[quad_count * 6];
+            int first = quad_count * 4;
+            quad_indices[0] = first;
+            quad_indices[1] = first + 1;
+            quad_indices[2] = first + 2;
+            quad_indices[3] = first;
+            quad_indices[4] = first + 2;
+            quad_indices[5] = first + 3;
+            quad_count++;
+        }
+        pen_x += (float)glyph->advance;
+    }
+
+    if(quad_count > 0) {
+        SDL_RenderGeometry(renderer, atlas->texture, vertices, quad_count * 4, indices, quad_count * 6);
+    }
+}
+
+void text_draw_right(TextAtlas* atlas, SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
+    text_draw(atlas, renderer, text, x - text_width(atlas, text), y, color);
+}
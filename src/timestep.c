@@ -0,0 +1,37 @@
+#include "timestep.h"
+
+void timestep_init(Timestep* timestep, int tick_rate, int max_ticks) {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    tick_rate = tick_rate > 0 ? tick_rate : TIMESTEP_DEFAULT_TICK_RATE;
+
+    timestep->tick_length = frequency / (Uint64)tick_rate;
+    timestep->tick_length = timestep->tick_length > 0 ? timestep->tick_length : 1;
+    timestep->tick_delta = (float)((double)timestep->tick_length / (double)frequency);
+    timestep->max_ticks = max_ticks > 0 ? max_ticks : 1;
+    timestep->accumulator = 0;
+    timestep->previous_counter = SDL_GetPerformanceCounter();
+}
+
+int timestep_begin_frame(Timestep* timestep) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 elapsed = now - timestep->previous_counter;
+    timestep->previous_counter = now;
+    return timestep_advance(timestep, elapsed);
+}
+
+int timestep_advance(Timestep* timestep, Uint64 elapsed) {
+    timestep->accumulator += elapsed;
+
+    Uint64 ticks = timestep->accumulator / timestep->tick_length;
+    if(ticks > (Uint64)timestep->max_ticks) {
+        //a hitch (or a breakpoint), the simulation slows down for a moment instead of spiraling
+        ticks = (Uint64)timestep->max_ticks;
+        timestep->accumulator = ticks * timestep->tick_length;
+    }
+    timestep->accumulator -= ticks * timestep->tick_length;
+    return (int)ticks;
+}
+
+float timestep_alpha(Timestep* timestep) {
+    return (float)((double)timestep->accumulator / (double)timestep->tick_length);
+}
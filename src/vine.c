@@ -1,10 +1,117 @@
 #include "vine.h"
 #include "hf_line.h"
 #include "hf_intersection.h"
+#include "hf_batch.h"
 
-void vine_reset(Vine* vine) {
-    vine->point_count = 0;
-    vine->angle = (float)M_PI / 2.f;
+static int vine__grid_bucket(int cell_x, int cell_y) {
+    unsigned int hash = ((unsigned int)cell_x * 73856093u) ^ ((unsigned int)cell_y * 19349663u);
+    return (int)(hash & (VINE_GRID_BUCKET_COUNT - 1));
+}
+
+static int vine__grid_cell(float value) {
+    int cell = (int)(value / VINE_GRID_CELL_SIZE);
+    return (float)cell * VINE_GRID_CELL_SIZE > value ? cell - 1 : cell;//floor, also for negative values
+}
+
+//fills the buckets of every cell the line's bounding box touches, returns how many were written
+static int vine__grid_line_buckets(HF_Line line, int* buckets) {
+    bool x_sorted = line.start.x <= line.end.x;
+    bool y_sorted = line.start.y <= line.end.y;
+    int min_x = vine__grid_cell(x_sorted ? line.start.x : line.end.x);
+    int max_x = vine__grid_cell(x_sorted ? line.end.x : line.start.x);
+    int min_y = vine__grid_cell(y_sorted ? line.start.y : line.end.y);
+    int max_y = vine__grid_cell(y_sorted ? line.end.y : line.start.y);
+    //can't happen with lines of VINE_EXPAND_DISTANCE, but keeps the node slots from overflowing
+    max_x = max_x > min_x + 1 ? min_x + 1 : max_x;
+    max_y = max_y > min_y + 1 ? min_y + 1 : max_y;
+
+    int count = 0;
+    for(int y = min_y; y <= max_y; y++) {
+        for(int x = min_x; x <= max_x; x++) {
+            buckets[count] = vine__grid_bucket(x, y);
+            count++;
+        }
+    }
+    return count;
+}
+
+static void vine__grid_insert(VineGrid* grid, HF_Line line, unsigned int line_index) {
+    int buckets[VINE_GRID_CELLS_PER_LINE];
+    int bucket_count = vine__grid_line_buckets(line, buckets);
+    int first_node = (int)(line_index & VINE_POINT_MASK) * VINE_GRID_CELLS_PER_LINE;
+
+    for(int i = 0; i < bucket_count; i++) {
+        int node_id = first_node + i + 1;
+        int next_id = grid->buckets[buckets[i]];
+
+        grid->nodes[node_id - 1] = (VineGridNode) {
+            .line = line_index,
+            .bucket = buckets[i] + 1,
+            .prev = 0,
+            .next = next_id
+        };
+        if(next_id) {
+            grid->nodes[next_id - 1].prev = node_id;
+        }
+        grid->buckets[buckets[i]] = node_id;
+    }
+}
+
+static void vine__grid_remove(VineGrid* grid, unsigned int line_index) {
+    int first_node = (int)(line_index & VINE_POINT_MASK) * VINE_GRID_CELLS_PER_LINE;
+
+    for(int i = 0; i < VINE_GRID_CELLS_PER_LINE; i++) {
+        VineGridNode* node = &grid->nodes[first_node + i];
+        if(!node->bucket) {
+            continue;
+        }
+
+        if(node->prev) {
+            grid->nodes[node->prev - 1].next = node->next;
+        }
+        else {
+            grid->buckets[node->bucket - 1] = node->next;
+        }
+        if(node->next) {
+            grid->nodes[node->next - 1].prev = node->prev;
+        }
+        node->bucket = 0;
+    }
+}
+
+#define VINE_SPRITE_SIZE 21
+#define VINE_SPRITE_REACH 16//from the line center, covers the rotated sprite plus the 1 pixel shadow offset
+#define VINE_MESH_LAYERS 2
+#define VINE_MAX_REGION_CELLS 64
+
+typedef struct VineMeshLayer_s {
+    SDL_Texture* texture;
+    int tex_offset_y;
+    int tex_w;
+    int tex_h;
+    SDL_FPoint uv[VINE_POINT_CAPACITY * 4];
+} VineMeshLayer;
+
+static HF_Line vine__line(Vine* vine, unsigned int line_index) {
+    return (HF_Line) {
+        .start = vine->points[(line_index - 1) & VINE_POINT_MASK],
+        .end   = vine->points[line_index & VINE_POINT_MASK]
+    };
+}
+
+void vine_reset(Vine* vine, HF_Vec2f position, float angle) {
+    vine->head = 0;
+    vine->tail = 0;
+    SDL_memset(&vine->grid, 0, sizeof(vine->grid));
+    vine->generation++;
+    vine->collision.valid = false;
+    vine->position = position;
+    vine->angle = angle;
+    vine->previous_angle = angle;
+}
+
+int vine_point_count(Vine* vine) {
+    return (int)(vine->tail - vine->head);
 }
 
 HF_Vec2f vine_next_point(Vine* vine) {
@@ -14,102 +121,432 @@ HF_Vec2f vine_next_point(Vine* vine) {
     return hf_vec2f_add(vine->position, expand_dir);
 }
 
-static void vine__draw_segment(SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, int offset_x, HF_Vec2f start, HF_Vec2f end) {
-    HF_Vec2f mid_point = hf_vec2f_divide(hf_vec2f_add(start, end), 2.f);
+//end of the moving tip as drawn, which may lag behind vine_next_point by a fraction of a tick
+static HF_Vec2f vine__tip_end(Vine* vine, VineRender* render) {
+    HF_Vec2f expand_dir = { VINE_EXPAND_DISTANCE, 0.f };
+    expand_dir = hf_vec2f_rotate(expand_dir, render->tip_angle);
+
+    return hf_vec2f_add(vine->position, expand_dir);
+}
+
+//quad of the sprite drawn over a line, rotated to follow it
+static void vine__mesh_quad(SDL_FPoint* corners, HF_Vec2f start, HF_Vec2f end) {
+    float center_x = (start.x + end.x) * .5f;
+    float center_y = (start.y + end.y) * .5f;
 
-    SDL_Rect src_rect = {
-        offset_x,
-        tex_offset_y,
-        21,
-        21
-    };
-    SDL_Rect dest_rect = {
-        (int)mid_point.x - 10,
-        (int)mid_point.y - 10,
-        21,
-        21
+    //lines are always VINE_EXPAND_DISTANCE long, so scaling is enough to normalize
+    //rotating by the line angle - 90 degrees means cos = dir.y and sin = -dir.x, no trig needed
+    float scale = (VINE_SPRITE_SIZE / 2.f) / VINE_EXPAND_DISTANCE;
+    float dir_x = (start.x - end.x) * scale;
+    float dir_y = (start.y - end.y) * scale;
+
+    //x axis of the sprite is (dir_y, -dir_x), y axis is (dir_x, dir_y)
+    corners[0] = (SDL_FPoint) { center_x - dir_y - dir_x, center_y + dir_x - dir_y };//top left
+    corners[1] = (SDL_FPoint) { center_x + dir_y - dir_x, center_y - dir_x - dir_y };//top right
+    corners[2] = (SDL_FPoint) { center_x + dir_y + dir_x, center_y - dir_x + dir_y };//bottom right
+    corners[3] = (SDL_FPoint) { center_x - dir_y + dir_x, center_y + dir_x + dir_y };//bottom left
+}
+
+//two triangles per slot, repeated twice so that any run of slots in the ring is contiguous
+static int* vine__mesh_indices(void) {
+    static int indices[VINE_POINT_CAPACITY * 2 * 6];
+    static bool ready = false;
+
+    if(!ready) {
+        for(int i = 0; i < VINE_POINT_CAPACITY * 2; i++) {
+            int first_corner = (i & VINE_POINT_MASK) * 4;
+            indices[i * 6 + 0] = first_corner + 0;
+            indices[i * 6 + 1] = first_corner + 1;
+            indices[i * 6 + 2] = first_corner + 2;
+            indices[i * 6 + 3] = first_corner + 0;
+            indices[i * 6 + 4] = first_corner + 2;
+            indices[i * 6 + 5] = first_corner + 3;
+        }
+        ready = true;
+    }
+    return indices;
+}
+
+//texture coordinates only depend on the slot, so each layer is built once and shared by every vine
+static SDL_FPoint* vine__mesh_layer_uv(SDL_Texture* texture, int tex_offset_y, int tex_w, int tex_h) {
+    static VineMeshLayer layers[VINE_MESH_LAYERS];
+    static int next_layer = 0;
+
+    for(int i = 0; i < VINE_MESH_LAYERS; i++) {
+        VineMeshLayer* layer = &layers[i];
+        if(layer->texture == texture && layer->tex_offset_y == tex_offset_y && layer->tex_w == tex_w && layer->tex_h == tex_h) {
+            return layer->uv;
+        }
+    }
+
+    VineMeshLayer* layer = &layers[next_layer];
+    next_layer = (next_layer + 1) % VINE_MESH_LAYERS;
+
+    layer->texture = texture;
+    layer->tex_offset_y = tex_offset_y;
+    layer->tex_w = tex_w;
+    layer->tex_h = tex_h;
+    for(int i = 0; i < VINE_POINT_CAPACITY; i++) {
+        int val = i % 6;//rand() % 4;
+        float u0 = (float)(val * VINE_SPRITE_SIZE) / (float)tex_w;
+        float u1 = (float)(val * VINE_SPRITE_SIZE + VINE_SPRITE_SIZE) / (float)tex_w;
+        float v0 = (float)tex_offset_y / (float)tex_h;
+        float v1 = (float)(tex_offset_y + VINE_SPRITE_SIZE) / (float)tex_h;
+
+        layer->uv[i * 4 + 0] = (SDL_FPoint) { u0, v0 };
+        layer->uv[i * 4 + 1] = (SDL_FPoint) { u1, v0 };
+        layer->uv[i * 4 + 2] = (SDL_FPoint) { u1, v1 };
+        layer->uv[i * 4 + 3] = (SDL_FPoint) { u0, v1 };
+    }
+    return layer->uv;
+}
+
+//draws the listed quads with the color mods of texture, offset only moves the corners that are drawn
+static void vine__draw_mesh(VineRender* render, SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, HF_Vec2f offset, int* indices, int quad_count) {
+    static SDL_FPoint offset_mesh[VINE_POINT_CAPACITY * 4];
+
+    int tex_w;
+    int tex_h;
+    if(SDL_QueryTexture(texture, NULL, NULL, &tex_w, &tex_h)) {
+        return;
+    }
+    SDL_FPoint* uv = vine__mesh_layer_uv(texture, tex_offset_y, tex_w, tex_h);
+
+    SDL_FPoint* mesh = render->mesh;
+    if(offset.x != 0.f || offset.y != 0.f) {
+        //quads in consecutive slots are moved as one run, vine_draw has at most two (the ring wraps once)
+        int i = 0;
+        while(i < quad_count) {
+            int first_corner = indices[i * 6];
+            int run = 1;
+            while(i + run < quad_count && indices[(i + run) * 6] == first_corner + run * 4) {
+                run++;
+            }
+            hf_batch_translate_xy(&render->mesh[first_corner].x, &offset_mesh[first_corner].x, run * 4, offset);
+            i += run;
+        }
+        mesh = offset_mesh;
+    }
+
+    //SDL_RenderGeometry ignores the texture color and alpha mods, so they go in the vertex color
+    SDL_Color color;
+    SDL_GetTextureColorMod(texture, &color.r, &color.g, &color.b);
+    SDL_GetTextureAlphaMod(texture, &color.a);
+
+    SDL_RenderGeometryRaw(
+        renderer,
+        texture,
+        &mesh[0].x, sizeof(SDL_FPoint),
+        &color, 0,
+        &uv[0].x, sizeof(SDL_FPoint),
+        VINE_POINT_CAPACITY * 4,
+        indices, quad_count * 6, sizeof(int)
+    );
+}
+
+//pixels a sprite centered there and its shadow can touch
+static SDL_Rect vine__sprite_bounds(float center_x, float center_y) {
+    int x = (int)SDL_floorf(center_x);
+    int y = (int)SDL_floorf(center_y);
+    return (SDL_Rect) {
+        x - VINE_SPRITE_REACH,
+        y - VINE_SPRITE_REACH,
+        VINE_SPRITE_REACH * 2 + 1,
+        VINE_SPRITE_REACH * 2 + 1
     };
-    float deg = hf_vec2f_angle(hf_vec2f_subtract(start, end)) * (float)(180.0 / M_PI);
-    SDL_RenderCopyEx(renderer, texture, &src_rect, &dest_rect, deg - 90.f, NULL, SDL_FLIP_NONE);
 }
 
-void vine_draw(Vine* vine, SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, HF_Vec2f offset) {
-    if(vine_collision_self(vine, NULL)){
+static void vine__damage_add(VineDamage* damage, SDL_Rect rect) {
+    if(damage->all || SDL_RectEmpty(&rect)) {
+        return;
+    }
+
+    for(int i = 0; i < damage->rect_count; i++) {
+        if(SDL_HasIntersection(&damage->rects[i], &rect)) {
+            SDL_UnionRect(&damage->rects[i], &rect, &damage->rects[i]);
+            return;
+        }
+    }
+    if(damage->rect_count < VINE_MAX_DAMAGE_RECTS) {
+        damage->rects[damage->rect_count] = rect;
+        damage->rect_count++;
+        return;
+    }
+    SDL_UnionRect(&damage->rects[damage->rect_count - 1], &rect, &damage->rects[damage->rect_count - 1]);
+}
+
+//same for the quad drawn over a line, its center is halfway between opposite corners
+static SDL_Rect vine__quad_bounds(const SDL_FPoint* corners) {
+    return vine__sprite_bounds((corners[0].x + corners[2].x) * .5f, (corners[0].y + corners[2].y) * .5f);
+}
+
+//brings the mesh up to date with the lines the vine dropped and added since the last call
+static void vine__render_sync(Vine* vine, VineRender* render) {
+    if(render->generation != vine->generation) {
+        render->generation = vine->generation;
+        render->head = vine->head;
+        render->tail = vine->head;
+        render->tip_angle = vine->angle;
+        render->damage = (VineDamage) { .all = true };
+    }
+
+    //dropped lines are erased where the mesh last had them, their points may be overwritten already
+    unsigned int drawn_end = render->tail > render->head ? render->tail : render->head + 1;
+    for(unsigned int line = render->head + 1; line != vine->head + 1 && line != drawn_end; line++) {
+        vine__damage_add(&render->damage, vine__quad_bounds(&render->mesh[(line & VINE_POINT_MASK) * 4]));
+    }
+    render->head = vine->head;
+
+    unsigned int first_line = render->tail > vine->head + 1 ? render->tail : vine->head + 1;
+    for(unsigned int line = first_line; line < vine->tail; line++) {
+        HF_Line vine_line = vine__line(vine, line);
+        SDL_FPoint* corners = &render->mesh[(line & VINE_POINT_MASK) * 4];
+        vine__mesh_quad(corners, vine_line.start, vine_line.end);
+        vine__damage_add(&render->damage, vine__quad_bounds(corners));
+    }
+    render->tail = vine->tail;
+}
+
+void vine_draw(Vine* vine, VineRender* render, SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, HF_Vec2f offset) {
+    vine__render_sync(vine, render);
+    if(vine->collision.valid && vine->collision.hit){//result from the last update, drawing doesn't test collision again
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
     }
 
-    for(int i = 1; i < vine->point_count; i++) {
-        HF_Vec2f prev_point = hf_vec2f_add(offset, vine->points[i - 1]);
-        HF_Vec2f this_point = hf_vec2f_add(offset, vine->points[i]);
+    //desenha parte movel do cipo, no slot livre depois da última linha
+    unsigned int tip_slot = vine->tail & VINE_POINT_MASK;
+    vine__mesh_quad(&render->mesh[tip_slot * 4], vine->position, vine__tip_end(vine, render));
 
-        int val = i % 6;//rand() % 4;
-        vine__draw_segment(renderer, texture, tex_offset_y, val * 21, prev_point, this_point);
+    //lines in slots head + 1 until tail - 1, followed by the tip
+    int quad_count = vine_point_count(vine) > 0 ? vine_point_count(vine) : 1;
+    unsigned int first_slot = (vine->tail + 1 - (unsigned int)quad_count) & VINE_POINT_MASK;
+
+    vine__draw_mesh(render, renderer, texture, tex_offset_y, offset, &vine__mesh_indices()[first_slot * 6], quad_count);
+}
+
+static int vine__compare_age(const void* a, const void* b) {
+    unsigned int age_a = *(const unsigned int*)a;
+    unsigned int age_b = *(const unsigned int*)b;
+    return age_a < age_b ? -1 : (age_a > age_b ? 1 : 0);
+}
+
+void vine_draw_region(Vine* vine, VineRender* render, SDL_Renderer* renderer, SDL_Texture* texture, int tex_offset_y, HF_Vec2f offset, SDL_Rect region) {
+    static unsigned int ages[VINE_POINT_CAPACITY * VINE_GRID_CELLS_PER_LINE];
+    static int indices[VINE_POINT_CAPACITY * 6];
+
+    vine__render_sync(vine, render);
+
+    //a line whose sprite reaches the region has its end points at most this far from it
+    float reach = (float)VINE_SPRITE_REACH + VINE_EXPAND_DISTANCE / 2.f;
+    int min_x = vine__grid_cell((float)region.x - offset.x - reach);
+    int min_y = vine__grid_cell((float)region.y - offset.y - reach);
+    int max_x = vine__grid_cell((float)(region.x + region.w) - offset.x + reach);
+    int max_y = vine__grid_cell((float)(region.y + region.h) - offset.y + reach);
+    if((max_x - min_x + 1) * (max_y - min_y + 1) > VINE_MAX_REGION_CELLS) {//big regions are cheaper to just draw whole
+        vine_draw(vine, render, renderer, texture, tex_offset_y, offset);
+        return;
     }
 
-    //desenha parte movel do cipo
-    {
-        HF_Vec2f expand_dir = { VINE_EXPAND_DISTANCE, 0.f };
-        expand_dir = hf_vec2f_rotate(expand_dir, vine->angle);
+    int buckets[VINE_MAX_REGION_CELLS];
+    int bucket_count = 0;
+    int age_count = 0;
+    for(int y = min_y; y <= max_y; y++) {
+        for(int x = min_x; x <= max_x; x++) {
+            int bucket = vine__grid_bucket(x, y);
+            bool repeated = false;
+            for(int i = 0; i < bucket_count; i++) {
+                repeated = repeated || buckets[i] == bucket;
+            }
+            if(repeated) {
+                continue;
+            }
+            buckets[bucket_count] = bucket;
+            bucket_count++;
 
-        HF_Vec2f next_pos = hf_vec2f_add(offset, hf_vec2f_add(vine->position, expand_dir));
-        HF_Vec2f vine_pos = hf_vec2f_add(offset, vine->position);
+            for(int node_id = vine->grid.buckets[bucket]; node_id; node_id = vine->grid.nodes[node_id - 1].next) {
+                ages[age_count] = vine->grid.nodes[node_id - 1].line - vine->head;
+                age_count++;
+            }
+        }
+    }
 
-        int val = vine->point_count % 6;//rand() % 4;
-        vine__draw_segment(renderer, texture, tex_offset_y, val * 21, vine_pos, next_pos);
+    //oldest first, same order as vine_draw, skipping lines found in more than one cell
+    SDL_qsort(ages, (size_t)age_count, sizeof(unsigned int), vine__compare_age);
+    int quad_count = 0;
+    for(int i = 0; i < age_count; i++) {
+        if(i > 0 && ages[i] == ages[i - 1]) {
+            continue;
+        }
+        unsigned int slot = (vine->head + ages[i]) & VINE_POINT_MASK;
+        SDL_memcpy(&indices[quad_count * 6], &vine__mesh_indices()[slot * 6], 6 * sizeof(int));
+        quad_count++;
     }
+
+    unsigned int tip_slot = vine->tail & VINE_POINT_MASK;
+    vine__mesh_quad(&render->mesh[tip_slot * 4], vine->position, vine__tip_end(vine, render));
+    SDL_memcpy(&indices[quad_count * 6], &vine__mesh_indices()[tip_slot * 6], 6 * sizeof(int));
+    quad_count++;
+
+    vine__draw_mesh(render, renderer, texture, tex_offset_y, offset, indices, quad_count);
+}
+
+int vine_take_damage(Vine* vine, VineRender* render, SDL_Rect* rects) {
+    vine__render_sync(vine, render);
+    VineDamage* damage = &render->damage;
+
+    HF_Vec2f tip_end = vine__tip_end(vine, render);
+    SDL_Rect tip = vine__sprite_bounds((vine->position.x + tip_end.x) * .5f, (vine->position.y + tip_end.y) * .5f);
+    if(!SDL_RectEquals(&tip, &damage->tip)) {
+        vine__damage_add(damage, damage->tip);
+        vine__damage_add(damage, tip);
+        damage->tip = tip;
+    }
+
+    int rect_count = damage->all ? -1 : damage->rect_count;
+    for(int i = 0; i < rect_count; i++) {
+        rects[i] = damage->rects[i];
+    }
+    damage->all = false;
+    damage->rect_count = 0;
+    return rect_count;
 }
 
 void vine_process_input(Vine* vine, VineInput input, float turn_multiplier, float delta) {
-    vine->angle += input.turn * turn_multiplier * delta;
+    float angle = vine->angle + input.turn * turn_multiplier * delta;
+    vine->previous_angle = vine->angle;
+    if(angle != vine->angle) {
+        vine->angle = angle;
+        vine->collision.valid = false;
+    }
+}
+
+void vine_hold(Vine* vine) {
+    vine->previous_angle = vine->angle;
+}
+
+void vine_interpolate_tip(Vine* vine, VineRender* render, float alpha) {
+    vine__render_sync(vine, render);
+    render->tip_angle = vine->previous_angle + (vine->angle - vine->previous_angle) * alpha;
 }
 
 void vine_expand(Vine* vine) {
     HF_Vec2f vec = { VINE_EXPAND_DISTANCE, 0.f };
     vec = hf_vec2f_rotate(vec, vine->angle);
 
-    if(vine->point_count == 0) {//needs to add starting position as a point
-        vine->points[0] = vine->position;
-        vine->point_count++;
+    if(vine->tail == vine->head) {//needs to add starting position as a point
+        vine->points[vine->tail & VINE_POINT_MASK] = vine->position;
+        vine->tail++;
     }
 
-    if(vine->point_count >= VINE_MAX_POINTS) {//mover todos points um indice abaixo
-        for(int i = 1; i < VINE_MAX_POINTS; i++) {
-            vine->points[i - 1] = vine->points[i];
-        }
-    }
-    else {
-        vine->point_count++;
+    if(vine_point_count(vine) >= VINE_MAX_POINTS) {//esquece o point mais antigo
+        vine->head++;
+        vine__grid_remove(&vine->grid, vine->head);
     }
 
-    vine->points[vine->point_count - 1] = vine->position = hf_vec2f_add(vine->position, vec);
+    vine->points[vine->tail & VINE_POINT_MASK] = vine->position = hf_vec2f_add(vine->position, vec);
+    HF_Line line = vine__line(vine, vine->tail);
+    vine__grid_insert(&vine->grid, line, vine->tail);
+    vine->tail++;
+    vine->collision.valid = false;
 }
 
-static void vine__get_lines(Vine* vine, HF_Line* lines) {
-    for(int i = 1; i < vine->point_count; i++) {
-        HF_Vec2f this_point = vine->points[i];
-        HF_Vec2f prev_point = vine->points[i - 1];
+VineIterator vine_iterator(Vine* vine) {
+    return (VineIterator) {
+        .vine = vine,
+        .cursor = vine->head
+    };
+}
 
-        lines[i - 1] = (HF_Line) {
-            .start = prev_point,
-            .end   = this_point
-        };
+bool vine_iterator_next(VineIterator* iterator, HF_Vec2f* point) {
+    if(iterator->cursor == iterator->vine->tail) {
+        return false;
     }
+    *point = iterator->vine->points[iterator->cursor & VINE_POINT_MASK];
+    iterator->cursor++;
+    return true;
 }
 
-bool vine_collision_self(Vine* vine, HF_Vec2f* hit_point) {
-    HF_Line vine_lines[VINE_MAX_POINTS - 1];
-    vine__get_lines(vine, vine_lines);
+//returns the line from the next point to the one after it, advancing a single point
+bool vine_iterator_next_line(VineIterator* iterator, HF_Line* line) {
+    Vine* vine = iterator->vine;
+    if(vine->tail - iterator->cursor < 2) {
+        return false;
+    }
+
+    *line = (HF_Line) {
+        .start = vine->points[iterator->cursor & VINE_POINT_MASK],
+        .end   = vine->points[(iterator->cursor + 1) & VINE_POINT_MASK]
+    };
+    iterator->cursor++;
+    return true;
+}
 
-    int line_count = vine->point_count - 1;
+static VineCollision vine__collision_self(Vine* vine) {
+    VineCandidates* candidates = &vine->candidates;
 
-    //só checa colisão do ponto frontal, não checa colisão com a última linha
-    for(int i = 0; i < line_count - 1; i++) {
-        HF_Line front_line = { vine->position, vine_next_point(vine) };
-        HF_Line other_line = vine_lines[i];
+    HF_Line front_line = { vine->position, vine_next_point(vine) };
+    unsigned int last_line = vine->tail - 1;
 
-        if(hf_intersection_lines(front_line, other_line, hit_point)) {
-            return true;
+    int buckets[VINE_GRID_CELLS_PER_LINE];
+    int bucket_count = vine__grid_line_buckets(front_line, buckets);
+
+    //o grid só tem as linhas que tocam as mesmas células da linha frontal
+    int candidate_count = 0;
+    for(int i = 0; i < bucket_count; i++) {
+        bool repeated = false;
+        for(int j = 0; j < i; j++) {
+            repeated = repeated || buckets[j] == buckets[i];
+        }
+        if(repeated) {
+            continue;
+        }
+
+        for(int node_id = vine->grid.buckets[buckets[i]]; node_id; node_id = vine->grid.nodes[node_id - 1].next) {
+            unsigned int line_index = vine->grid.nodes[node_id - 1].line;
+            if(line_index == last_line) {//não checa colisão com a última linha
+                continue;
+            }
+
+            HF_Line line = vine__line(vine, line_index);
+            candidates->start_x[candidate_count] = line.start.x;
+            candidates->start_y[candidate_count] = line.start.y;
+            candidates->end_x[candidate_count] = line.end.x;
+            candidates->end_y[candidate_count] = line.end.y;
+            candidates->lines[candidate_count] = line_index;
+            candidate_count++;
+        }
+    }
+
+    int hit_count = hf_batch_lines_hit(front_line, candidates->start_x, candidates->start_y, candidates->end_x, candidates->end_y, candidate_count, candidates->hits);
+
+    //keeps the hit of the oldest line, same as walking the vine from the start
+    VineCollision collision = { .valid = true, .hit = false };
+    unsigned int hit_age = 0;
+    unsigned int hit_line = 0;
+    for(int i = 0; i < hit_count; i++) {
+        unsigned int line_index = candidates->lines[candidates->hits[i]];
+        unsigned int age = line_index - vine->head;
+        if(!collision.hit || age < hit_age) {
+            collision.hit = true;
+            hit_age = age;
+            hit_line = line_index;
         }
     }
-    return false;
+    //the batch only answers whether lines cross, the point comes from the one line that matters
+    if(collision.hit) {
+        hf_intersection_lines(front_line, vine__line(vine, hit_line), &collision.hit_point);
+    }
+    return collision;
+}
+
+bool vine_collision_self(Vine* vine, HF_Vec2f* hit_point) {
+    if(!vine->collision.valid) {
+        vine->collision = vine__collision_self(vine);
+        vine->collision_tests++;
+    }
+
+    if(vine->collision.hit && hit_point) {
+        *hit_point = vine->collision.hit_point;
+    }
+    return vine->collision.hit;
 }
@@ -1,140 +1,431 @@
 #include "world.h"
 #include "hf_vec.h"
+#include "hf_batch.h"
+
+static void draw_tiled(SDL_Renderer* renderer, SDL_Texture* texture, int pos_x, int pos_y, int repeat_x, int repeat_y) {
+    int tex_w;
+    int tex_h;
+    SDL_QueryTexture(texture, NULL, NULL, &tex_w, &tex_h);
+
+    for(int x = 0; x < repeat_x; x++) {
+        for(int y = 0; y < repeat_y; y++) {
+            SDL_Rect dest_rect = {
+                pos_x + x * tex_w,
+                pos_y + y * tex_h,
+                tex_w,
+                tex_h,
+            };
+            SDL_RenderCopy(renderer, texture, NULL, &dest_rect);
+        }
+    }
+}
 
-static void fill_circle(SDL_Renderer* renderer, HF_Vec2f center, int radius) {
-    float width = (float)radius;
-    float radius_sqr = (float)(radius * radius);
+static void world__mark_all_dirty(World* world) {
+    world->dirty_rects[0] = (SDL_Rect) { 0, 0, world->w, world->h };
+    world->dirty_rect_count = 1;
+}
 
-    for(int i = 0; i < radius; i++) {
-        HF_Vec2f point = hf_vec2f_add(center, (HF_Vec2f) { width, (float)i });
-        while(hf_vec2f_sqr_magnitude(hf_vec2f_subtract(point, center)) > radius_sqr) {
-            width -= 1.f;
-            point = hf_vec2f_add(center, (HF_Vec2f) { (float)width, (float)i });
-        }
+//fills the whole texture with copies of the tile
+static void world__bake_layer(World* world, SDL_Renderer* renderer, SDL_Texture* target, SDL_Texture* tile, SDL_Color clear_color) {
+    SDL_SetRenderTarget(renderer, target);
+    SDL_SetRenderDrawColor(renderer, clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+    SDL_RenderClear(renderer);
 
-        SDL_RenderDrawLine(
-            renderer,
-            (int)(center.x - width), (int)(center.y + (float)i),
-            (int)(center.x + width), (int)(center.y + (float)i)
-        );
-        SDL_RenderDrawLine(
-            renderer,
-            (int)(center.x - width), (int)(center.y - (float)i),
-            (int)(center.x + width), (int)(center.y - (float)i)
-        );
+    int tile_w;
+    int tile_h;
+    if(!tile || SDL_QueryTexture(tile, NULL, NULL, &tile_w, &tile_h)) {
+        return;
     }
+    draw_tiled(renderer, tile, 0, 0, (world->w + tile_w - 1) / tile_w, (world->h + tile_h - 1) / tile_h);
 }
 
-void world_init(World* world, SDL_Renderer* renderer, int w, int h) {
+static void world__bake_background(World* world, SDL_Renderer* renderer) {
     SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+    SDL_BlendMode prev_mode;
+    SDL_GetRenderDrawBlendMode(renderer, &prev_mode);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    world__bake_layer(world, renderer, world->bg_ground, world->tile_ground, (SDL_Color) { 255, 0, 0, 255 });
+    world__bake_layer(world, renderer, world->bg_sky, world->tile_sky, (SDL_Color) { 0, 255, 255, 255 });
+
+    SDL_SetRenderDrawBlendMode(renderer, prev_mode);
+    SDL_SetRenderTarget(renderer, prev_target);
+    world->background_dirty = false;
+    world__mark_all_dirty(world);
+}
+
+//antialiased edge pixels of one bubble row, coverage from the distance to the circle
+static void world__rasterize_edge(Uint8* row, int x_from, int x_to, HF_Circle bubble, float dy) {
+    for(int x = x_from; x <= x_to; x++) {
+        float dx = (float)x + .5f - bubble.position.x;
+        float amount = bubble.radius + .5f - SDL_sqrtf(dx * dx + dy * dy);
+        if(amount <= 0.f) {
+            continue;
+        }
+        Uint8 value = amount >= 1.f ? 255 : (Uint8)(amount * 255.f + .5f);
+        row[x] = value > row[x] ? value : row[x];
+    }
+}
+
+//8-bit coverage of all the bubbles (255 inside) in one pass, each row span is found analytically
+static void world__rasterize_bubbles(World* world) {
+    int w = world->w;
+    int h = world->h;
+    SDL_memset(world->coverage, 0, (size_t)w * (size_t)h);
+
+    for(int i = 0; i < world->bubble_count; i++) {
+        HF_Circle bubble = world->bubbles[i];
+        float reach = world->mask_antialias ? bubble.radius + .5f : bubble.radius;
+        float inner = bubble.radius - .5f;
+
+        int y_from = (int)SDL_floorf(bubble.position.y - reach);
+        int y_to = (int)SDL_ceilf(bubble.position.y + reach);
+        y_from = y_from < 0 ? 0 : y_from;
+        y_to = y_to > h - 1 ? h - 1 : y_to;
+
+        for(int y = y_from; y <= y_to; y++) {
+            float dy = (float)y + .5f - bubble.position.y;
+            float outer_sqr = reach * reach - dy * dy;
+            if(outer_sqr <= 0.f) {
+                continue;
+            }
+            float outer = SDL_sqrtf(outer_sqr);
+            int x_from = (int)SDL_ceilf(bubble.position.x - outer - .5f);
+            int x_to = (int)SDL_floorf(bubble.position.x + outer - .5f);
+            x_from = x_from < 0 ? 0 : x_from;
+            x_to = x_to > w - 1 ? w - 1 : x_to;
+            if(x_from > x_to) {
+                continue;
+            }
+
+            Uint8* row = world->coverage + (size_t)y * (size_t)w;
+            if(!world->mask_antialias) {
+                SDL_memset(row + x_from, 255, (size_t)(x_to - x_from + 1));
+                continue;
+            }
+
+            //fully covered middle, only the pixels near the edge need the distance
+            float inner_sqr = inner * inner - dy * dy;
+            int inner_from = x_to + 1;
+            int inner_to = x_to;
+            if(inner > 0.f && inner_sqr > 0.f) {
+                float inner_half = SDL_sqrtf(inner_sqr);
+                inner_from = (int)SDL_ceilf(bubble.position.x - inner_half - .5f);
+                inner_to = (int)SDL_floorf(bubble.position.x + inner_half - .5f);
+                inner_from = inner_from < x_from ? x_from : inner_from;
+                inner_to = inner_to > x_to ? x_to : inner_to;
+                if(inner_from <= inner_to) {
+                    SDL_memset(row + inner_from, 255, (size_t)(inner_to - inner_from + 1));
+                }
+                else {
+                    inner_from = x_to + 1;
+                    inner_to = x_to;
+                }
+            }
+            world__rasterize_edge(row, x_from, inner_from - 1, bubble, dy);
+            world__rasterize_edge(row, inner_to + 1, x_to, bubble, dy);
+        }
+    }
+}
+
+//writes base | (coverage ^ flip) * scale to every ARGB8888 pixel, flip 255 inverts the mask
+static void world__upload_mask(World* world, SDL_Texture* texture, Uint32 base, Uint8 flip, Uint32 scale) {
+    void* pixels;
+    int pitch;
+    if(!texture || SDL_LockTexture(texture, NULL, &pixels, &pitch)) {
+        return;
+    }
+
+    for(int y = 0; y < world->h; y++) {
+        const Uint8* src = world->coverage + (size_t)y * (size_t)world->w;
+        Uint32* dst = (Uint32*)((Uint8*)pixels + (size_t)y * (size_t)pitch);
+        for(int x = 0; x < world->w; x++) {
+            dst[x] = base | (Uint32)(src[x] ^ flip) * scale;
+        }
+    }
+    SDL_UnlockTexture(texture);
+}
+
+//every mask layer is derived from the same coverage, no render target passes
+static void world__draw_masks(World* world) {
+    world__rasterize_bubbles(world);
+
+    if(world->compose_mode == WORLD_COMPOSE_MODE_SinglePass) {
+        //alpha 255 on ground, 0 in bubbles
+        world__upload_mask(world, world->mask_all, 0, 255, 0x01000000);
+    }
+    else {
+        //white ground for mask_ground, white bubbles for mask_sky
+        world__upload_mask(world, world->mask_ground, 0xFF000000, 255, 0x010101);
+        world__upload_mask(world, world->mask_sky, 0xFF000000, 0, 0x010101);
+    }
+
+    world->masks_dirty = false;
+    world__mark_all_dirty(world);
+}
+
+static SDL_Texture* world__create_target(World* world, SDL_Renderer* renderer, int w, int h, SDL_BlendMode mode) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
+    world->texture_creations++;
+    SDL_SetTextureBlendMode(texture, mode);
+    return texture;
+}
+
+static SDL_Texture* world__create_mask(World* world, SDL_Renderer* renderer, int w, int h, SDL_BlendMode mode) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+    world->texture_creations++;
+    SDL_SetTextureBlendMode(texture, mode);
+    return texture;
+}
 
+static void world__destroy_target(SDL_Texture** texture) {
+    if(*texture) {
+        SDL_DestroyTexture(*texture);
+        *texture = NULL;
+    }
+}
+
+//simulation side only, world_init_render adds the textures
+void world_init(World* world, int w, int h) {
     world->w = w;
     world->h = h;
 
-    world->fg_ground = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->fg_ground, SDL_BLENDMODE_BLEND);
-    world->fg_sky = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->fg_sky, SDL_BLENDMODE_BLEND);
+    world->fg_ground = NULL;
+    world->fg_sky = NULL;
+    world->bg_ground = NULL;
+    world->bg_sky = NULL;
+    world->mask_ground = NULL;
+    world->mask_sky = NULL;
+    world->mask_all = NULL;
+    world->composed_ground = NULL;
+    world->composed_sky = NULL;
+    world->composed_all = NULL;
+    world->coverage = NULL;
+    world->mask_antialias = true;
+    world->compose_mode = WORLD_COMPOSE_MODE_Layered;
+    world->compose_ticks = 0;
+    world->texture_creations = 0;
+
+    world->bubble_grid = (WorldBubbleGrid) { 0 };
+    world->tile_ground = NULL;
+    world->tile_sky = NULL;
+    world->bubble_count = 0;
+    world->background_dirty = true;
+    world->masks_dirty = true;
+    world->foreground_valid = false;
+    world__mark_all_dirty(world);
+}
 
-    world->bg_ground = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->bg_ground, SDL_BLENDMODE_BLEND);
-    world->bg_sky = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->bg_sky, SDL_BLENDMODE_BLEND);
+void world_init_render(World* world, SDL_Renderer* renderer) {
+    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+    int w = world->w;
+    int h = world->h;
 
-    world->mask_ground = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->mask_ground, SDL_BLENDMODE_MOD);
-    world->mask_sky = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->mask_sky, SDL_BLENDMODE_MOD);
+    world->fg_ground = world__create_target(world, renderer, w, h, SDL_BLENDMODE_BLEND);
+    world->fg_sky = world__create_target(world, renderer, w, h, SDL_BLENDMODE_BLEND);
 
-    world->composed_ground = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->composed_ground, SDL_BLENDMODE_ADD);
-    world->composed_sky = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->composed_sky, SDL_BLENDMODE_ADD);
+    world->bg_ground = world__create_target(world, renderer, w, h, SDL_BLENDMODE_BLEND);
+    world->bg_sky = world__create_target(world, renderer, w, h, SDL_BLENDMODE_BLEND);
 
-    world->composed_all = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, w, h);
-    SDL_SetTextureBlendMode(world->composed_all, SDL_BLENDMODE_BLEND);
+    world->composed_all = world__create_target(world, renderer, w, h, SDL_BLENDMODE_BLEND);
+
+    world->coverage = SDL_malloc((size_t)w * (size_t)h);
+    SDL_memset(world->coverage, 0, (size_t)w * (size_t)h);
+
+    //the mask and intermediate targets depend on the mode
+    world_set_compose_mode(world, renderer, world->compose_mode);
+
+    world->background_dirty = true;
+    world->masks_dirty = true;
+    world->foreground_valid = false;
+    world__mark_all_dirty(world);
 
     SDL_SetRenderTarget(renderer, prev_target);
 }
 
 void world_deinit(World* world) {
-    SDL_DestroyTexture(world->fg_ground);
-    SDL_DestroyTexture(world->fg_sky);
+    world__destroy_target(&world->fg_ground);
+    world__destroy_target(&world->fg_sky);
 
-    SDL_DestroyTexture(world->bg_ground);
-    SDL_DestroyTexture(world->bg_sky);
+    world__destroy_target(&world->bg_ground);
+    world__destroy_target(&world->bg_sky);
 
-    SDL_DestroyTexture(world->mask_ground);
-    SDL_DestroyTexture(world->mask_sky);
+    world__destroy_target(&world->mask_ground);
+    world__destroy_target(&world->mask_sky);
+    world__destroy_target(&world->mask_all);
 
-    SDL_DestroyTexture(world->composed_ground);
-    SDL_DestroyTexture(world->composed_sky);
+    world__destroy_target(&world->composed_ground);
+    world__destroy_target(&world->composed_sky);
 
-    SDL_DestroyTexture(world->composed_all);
+    world__destroy_target(&world->composed_all);
+
+    SDL_free(world->coverage);
+    world->coverage = NULL;
+    world_bubble_grid_free(&world->bubble_grid);
 }
 
-void world_generate(World* world, SDL_Renderer* renderer) {
-    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+//single pass: mask_all is copied first so its alpha (255 ground, 0 bubble) sits in the destination,
+//then every layer picks its side of it through the destination alpha
+//  bg_sky:    color = src * (1 - dst_a)
+//  fg_sky:    color = src * (1 - dst_a) + dst * (1 - src_a)
+//  fg_ground: color = src * dst_a + dst, alpha = dst_a * (1 - src_a)
+//  bg_ground: color = src * dst_a + dst
+//fg_* are premultiplied (drawn over transparent black) so this matches the layered result
+static bool world__set_single_pass_blend_modes(World* world) {
+    SDL_BlendMode bg_sky_mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE_MINUS_DST_ALPHA, SDL_BLENDFACTOR_ZERO, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD
+    );
+    SDL_BlendMode fg_sky_mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE_MINUS_DST_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD
+    );
+    SDL_BlendMode fg_ground_mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_DST_ALPHA, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD
+    );
+    SDL_BlendMode bg_ground_mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_DST_ALPHA, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD
+    );
+
+    //renderers without custom blend support (software) fail here
+    return
+        SDL_SetTextureBlendMode(world->bg_sky, bg_sky_mode) == 0 &&
+        SDL_SetTextureBlendMode(world->fg_sky, fg_sky_mode) == 0 &&
+        SDL_SetTextureBlendMode(world->fg_ground, fg_ground_mode) == 0 &&
+        SDL_SetTextureBlendMode(world->bg_ground, bg_ground_mode) == 0
+    ;
+}
 
-    SDL_SetRenderTarget(renderer, world->mask_ground);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderClear(renderer);
+//allocates the render targets the mode needs and frees the rest
+//returns false (and stays on WORLD_COMPOSE_MODE_Layered) when the renderer can't do the single pass
+bool world_set_compose_mode(World* world, SDL_Renderer* renderer, WorldComposeMode mode) {
+    bool ok = true;
+    if(mode == WORLD_COMPOSE_MODE_SinglePass && !world__set_single_pass_blend_modes(world)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "single pass compose unsupported (%s), using layered", SDL_GetError());
+        mode = WORLD_COMPOSE_MODE_Layered;
+        ok = false;
+    }
 
-    SDL_SetRenderTarget(renderer, world->mask_sky);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    if(mode == WORLD_COMPOSE_MODE_SinglePass) {
+        world__destroy_target(&world->mask_ground);
+        world__destroy_target(&world->mask_sky);
+        world__destroy_target(&world->composed_ground);
+        world__destroy_target(&world->composed_sky);
 
+        if(!world->mask_all) {
+            world->mask_all = world__create_mask(world, renderer, world->w, world->h, SDL_BLENDMODE_NONE);
+        }
+        //alpha is left with the mask, it's meaningless on the screen
+        SDL_SetTextureBlendMode(world->composed_all, SDL_BLENDMODE_NONE);
+    }
+    else {
+        world__destroy_target(&world->mask_all);
+
+        SDL_SetTextureBlendMode(world->bg_ground, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(world->bg_sky, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(world->fg_ground, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(world->fg_sky, SDL_BLENDMODE_BLEND);
+
+        if(!world->mask_ground) {
+            world->mask_ground = world__create_mask(world, renderer, world->w, world->h, SDL_BLENDMODE_MOD);
+            world->mask_sky = world__create_mask(world, renderer, world->w, world->h, SDL_BLENDMODE_MOD);
+            world->composed_ground = world__create_target(world, renderer, world->w, world->h, SDL_BLENDMODE_ADD);
+            world->composed_sky = world__create_target(world, renderer, world->w, world->h, SDL_BLENDMODE_ADD);
+        }
+        SDL_SetTextureBlendMode(world->composed_all, SDL_BLENDMODE_BLEND);
+    }
+
+    world->compose_mode = mode;
+    world->masks_dirty = true;
+    world__mark_all_dirty(world);
+    return ok;
+}
+
+//bytes held by the world render targets
+size_t world_texture_memory(World* world) {
+    SDL_Texture* textures[] = {
+        world->bg_ground, world->bg_sky,
+        world->fg_ground, world->fg_sky,
+        world->mask_ground, world->mask_sky, world->mask_all,
+        world->composed_ground, world->composed_sky,
+        world->composed_all,
+    };
+
+    size_t bytes = 0;
+    for(size_t i = 0; i < SDL_arraysize(textures); i++) {
+        Uint32 format;
+        int w;
+        int h;
+        if(textures[i] && SDL_QueryTexture(textures[i], &format, NULL, &w, &h) == 0) {
+            bytes += (size_t)w * (size_t)h * SDL_BYTESPERPIXEL(format);
+        }
+    }
+    return bytes;
+}
+
+//simulation only, the masks are rasterized and uploaded on the next clear/compose
+void world_generate(World* world, Rng* rng) {
     world->bubble_count = 0;
     for(int i = 0; i < WORLD_NUM_CLUSTERS; i++) {
-        HF_Vec2f bubble_position = { (float)(rand() % world->w), (float)(rand() % world->h) };
-        int num_bubbles = (rand() % (WORLD_MAX_SIZE_CLUSTER - WORLD_MIN_SIZE_CLUSTER)) + 1 + WORLD_MIN_SIZE_CLUSTER;
+        HF_Vec2f bubble_position = { (float)rng_range(rng, world->w), (float)rng_range(rng, world->h) };
+        int num_bubbles = rng_range(rng, WORLD_MAX_SIZE_CLUSTER - WORLD_MIN_SIZE_CLUSTER) + 1 + WORLD_MIN_SIZE_CLUSTER;
 
         for(int j = 0; j < num_bubbles; j++) {
-            int size = (rand() % (WORLD_MAX_SIZE_HOLE - WORLD_MIN_SIZE_HOLE)) + WORLD_MIN_SIZE_HOLE;
+            int size = rng_range(rng, WORLD_MAX_SIZE_HOLE - WORLD_MIN_SIZE_HOLE) + WORLD_MIN_SIZE_HOLE;
 
             world->bubbles[world->bubble_count] = (HF_Circle) { .position = bubble_position, .radius = (float)size };
             world->bubble_count++;
 
             bubble_position = hf_vec2f_add(
                 bubble_position,
-                (HF_Vec2f) { (float)(rand() % (size * 2)) - (float)size, (float)(rand() % (size * 2)) - (float)size }
+                (HF_Vec2f) { (float)rng_range(rng, size * 2) - (float)size, (float)rng_range(rng, size * 2) - (float)size }
             );
         }
     }
 
-    //black to ground_tex
-    SDL_SetRenderTarget(renderer, world->mask_ground);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    for(int i = 0; i < world->bubble_count; i++) {
-        HF_Circle bubble = world->bubbles[i];
-        fill_circle(renderer, bubble.position, (int)bubble.radius);
+    world_bubble_grid_build(&world->bubble_grid, world->bubbles, world->bubble_count, WORLD_BUBBLE_GRID_CELL_SIZE);
+    world->masks_dirty = true;
+    world__mark_all_dirty(world);
+}
+
+void world_set_tiles(World* world, SDL_Renderer* renderer, SDL_Texture* tile_ground, SDL_Texture* tile_sky) {
+    if(world->tile_ground != tile_ground || world->tile_sky != tile_sky) {
+        world->tile_ground = tile_ground;
+        world->tile_sky = tile_sky;
+        world->background_dirty = true;
     }
 
-    //white to sky_tex
-    SDL_SetRenderTarget(renderer, world->mask_sky);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    for(int i = 0; i < world->bubble_count; i++) {
-        HF_Circle bubble = world->bubbles[i];
-        fill_circle(renderer, bubble.position, (int)bubble.radius);
+    if(world->background_dirty) {
+        world__bake_background(world, renderer);
     }
+}
 
-    SDL_SetRenderTarget(renderer, prev_target);
+//render target contents can be lost (SDL_RENDER_TARGETS_RESET), the baked layers get redrawn by world_clear
+void world_invalidate(World* world) {
+    world->background_dirty = true;
+    world->masks_dirty = true;
+    world->foreground_valid = false;
+}
+
+static void world__bake_dirty_layers(World* world, SDL_Renderer* renderer) {
+    if(world->background_dirty) {
+        world__bake_background(world, renderer);
+    }
+    if(world->masks_dirty) {
+        world__draw_masks(world);
+    }
 }
 
 void world_clear(World* world, SDL_Renderer* renderer) {
+    world__bake_dirty_layers(world, renderer);
+
     SDL_BlendMode prev_mode;
     SDL_GetRenderDrawBlendMode(renderer, &prev_mode);
 
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
-    SDL_SetRenderTarget(renderer, world->bg_ground);
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_SetRenderTarget(renderer, world->bg_sky);
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
-    SDL_RenderClear(renderer);
-
     SDL_SetRenderTarget(renderer, world->fg_ground);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
     SDL_RenderClear(renderer);
@@ -145,54 +436,284 @@ void world_clear(World* world, SDL_Renderer* renderer) {
 
 
     SDL_SetRenderDrawBlendMode(renderer, prev_mode);
+    world->foreground_valid = true;
+    world__mark_all_dirty(world);
 }
 
-void world_compose_texture(World* world, SDL_Renderer* renderer) {
-    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+//clears only rect of fg_*, for when the foreground keeps its contents between frames
+void world_clear_region(World* world, SDL_Renderer* renderer, SDL_Rect rect) {
+    world__bake_dirty_layers(world, renderer);
+
     SDL_BlendMode prev_mode;
     SDL_GetRenderDrawBlendMode(renderer, &prev_mode);
 
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
 
+    SDL_SetRenderTarget(renderer, world->fg_ground);
+    SDL_RenderFillRect(renderer, &rect);
+
+    SDL_SetRenderTarget(renderer, world->fg_sky);
+    SDL_RenderFillRect(renderer, &rect);
+
+    SDL_SetRenderDrawBlendMode(renderer, prev_mode);
+    world_mark_dirty(world, rect);
+}
+
+void world_mark_dirty(World* world, SDL_Rect rect) {
+    SDL_Rect world_rect = { 0, 0, world->w, world->h };
+    if(!SDL_IntersectRect(&rect, &world_rect, &rect)) {
+        return;
+    }
+
+    for(int i = 0; i < world->dirty_rect_count; i++) {
+        if(SDL_HasIntersection(&world->dirty_rects[i], &rect)) {
+            SDL_UnionRect(&world->dirty_rects[i], &rect, &world->dirty_rects[i]);
+            return;
+        }
+    }
+    if(world->dirty_rect_count < WORLD_MAX_DIRTY_RECTS) {
+        world->dirty_rects[world->dirty_rect_count] = rect;
+        world->dirty_rect_count++;
+        return;
+    }
+    SDL_UnionRect(&world->dirty_rects[world->dirty_rect_count - 1], &rect, &world->dirty_rects[world->dirty_rect_count - 1]);
+}
+
+static void world__compose_layered(World* world, SDL_Renderer* renderer, SDL_Rect* rect) {
     //ground
     SDL_SetRenderTarget(renderer, world->composed_ground);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-    SDL_RenderClear(renderer);
+    SDL_RenderFillRect(renderer, rect);
 
-    SDL_RenderCopy(renderer, world->bg_ground, NULL, NULL);
-    SDL_RenderCopy(renderer, world->fg_ground, NULL, NULL);
-    SDL_RenderCopy(renderer, world->mask_ground, NULL, NULL);
+    SDL_RenderCopy(renderer, world->bg_ground, rect, rect);
+    SDL_RenderCopy(renderer, world->fg_ground, rect, rect);
+    SDL_RenderCopy(renderer, world->mask_ground, rect, rect);
 
     //sky
     SDL_SetRenderTarget(renderer, world->composed_sky);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-    SDL_RenderClear(renderer);
+    SDL_RenderFillRect(renderer, rect);
 
-    SDL_RenderCopy(renderer, world->bg_sky, NULL, NULL);
-    SDL_RenderCopy(renderer, world->fg_sky, NULL, NULL);
-    SDL_RenderCopy(renderer, world->mask_sky, NULL, NULL);
+    SDL_RenderCopy(renderer, world->bg_sky, rect, rect);
+    SDL_RenderCopy(renderer, world->fg_sky, rect, rect);
+    SDL_RenderCopy(renderer, world->mask_sky, rect, rect);
 
     //all
     SDL_SetRenderTarget(renderer, world->composed_all);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    SDL_RenderFillRect(renderer, rect);
+
+    SDL_RenderCopy(renderer, world->composed_ground, rect, rect);
+    SDL_RenderCopy(renderer, world->composed_sky, rect, rect);
+}
+
+//blend modes set by world__set_single_pass_blend_modes, the order matters
+static void world__compose_single_pass(World* world, SDL_Renderer* renderer, SDL_Rect* rect) {
+    SDL_SetRenderTarget(renderer, world->composed_all);
 
-    SDL_RenderCopy(renderer, world->composed_ground, NULL, NULL);
-    SDL_RenderCopy(renderer, world->composed_sky, NULL, NULL);
+    SDL_RenderCopy(renderer, world->mask_all, rect, rect);
+    SDL_RenderCopy(renderer, world->bg_sky, rect, rect);
+    SDL_RenderCopy(renderer, world->fg_sky, rect, rect);
+    SDL_RenderCopy(renderer, world->fg_ground, rect, rect);
+    SDL_RenderCopy(renderer, world->bg_ground, rect, rect);
+}
+
+void world_compose_texture(World* world, SDL_Renderer* renderer) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    world__bake_dirty_layers(world, renderer);//a compose mode switch leaves the masks dirty
+    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+    SDL_BlendMode prev_mode;
+    SDL_GetRenderDrawBlendMode(renderer, &prev_mode);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    //only the regions that changed since the last composition are redone
+    for(int i = 0; i < world->dirty_rect_count; i++) {
+        if(world->compose_mode == WORLD_COMPOSE_MODE_SinglePass) {
+            world__compose_single_pass(world, renderer, &world->dirty_rects[i]);
+        }
+        else {
+            world__compose_layered(world, renderer, &world->dirty_rects[i]);
+        }
+    }
+    world->dirty_rect_count = 0;
 
     SDL_SetRenderDrawBlendMode(renderer, prev_mode);
     SDL_SetRenderTarget(renderer, prev_target);
+    world->compose_ticks += SDL_GetPerformanceCounter() - start;
 }
 
-bool world_point_is_in_bubble(World* world, HF_Vec2f point) {
-    for(int i = 0; i < world->bubble_count; i++) {
-        HF_Circle bubble = world->bubbles[i];
-        HF_Vec2f vec = hf_vec2f_subtract(bubble.position, point);
-        if(hf_vec2f_sqr_magnitude(vec) < bubble.radius * bubble.radius) {
-            return true;
+//cell range touched by the circle bounds, clamped to the grid
+static void world__bubble_grid_span(const WorldBubbleGrid* grid, HF_Circle bubble, int* x_from, int* y_from, int* x_to, int* y_to) {
+    *x_from = (int)((bubble.position.x - bubble.radius - grid->origin_x) * grid->inv_cell_size);
+    *y_from = (int)((bubble.position.y - bubble.radius - grid->origin_y) * grid->inv_cell_size);
+    *x_to = (int)((bubble.position.x + bubble.radius - grid->origin_x) * grid->inv_cell_size);
+    *y_to = (int)((bubble.position.y + bubble.radius - grid->origin_y) * grid->inv_cell_size);
+    *x_from = *x_from < 0 ? 0 : *x_from;
+    *y_from = *y_from < 0 ? 0 : *y_from;
+    *x_to = *x_to >= grid->columns ? grid->columns - 1 : *x_to;
+    *y_to = *y_to >= grid->rows ? grid->rows - 1 : *y_to;
+}
+
+//how the circle relates to the cell, padded a bit so float rounding in the query never picks a wrong cell
+static WorldBubbleCell world__bubble_grid_classify(const WorldBubbleGrid* grid, HF_Circle bubble, int x, int y) {
+    float pad = grid->cell_size * .001f;
+    float min_x = grid->origin_x + (float)x * grid->cell_size - pad;
+    float min_y = grid->origin_y + (float)y * grid->cell_size - pad;
+    float max_x = min_x + grid->cell_size + pad * 2.f;
+    float max_y = min_y + grid->cell_size + pad * 2.f;
+    float radius_sqr = bubble.radius * bubble.radius;
+
+    float far_x = SDL_max(bubble.position.x - min_x, max_x - bubble.position.x);
+    float far_y = SDL_max(bubble.position.y - min_y, max_y - bubble.position.y);
+    if(far_x * far_x + far_y * far_y < radius_sqr) {
+        return WORLD_BUBBLE_CELL_Full;
+    }
+
+    float near_x = bubble.position.x - SDL_clamp(bubble.position.x, min_x, max_x);
+    float near_y = bubble.position.y - SDL_clamp(bubble.position.y, min_y, max_y);
+    if(near_x * near_x + near_y * near_y < radius_sqr) {
+        return WORLD_BUBBLE_CELL_Boundary;
+    }
+    return WORLD_BUBBLE_CELL_Empty;
+}
+
+void world_bubble_grid_build(WorldBubbleGrid* grid, const HF_Circle* bubbles, int bubble_count, float cell_size) {
+    grid->columns = 0;
+    grid->rows = 0;
+    if(bubble_count <= 0) {
+        return;
+    }
+
+    float min_x = bubbles[0].position.x - bubbles[0].radius;
+    float min_y = bubbles[0].position.y - bubbles[0].radius;
+    float max_x = bubbles[0].position.x + bubbles[0].radius;
+    float max_y = bubbles[0].position.y + bubbles[0].radius;
+    for(int i = 1; i < bubble_count; i++) {
+        min_x = SDL_min(min_x, bubbles[i].position.x - bubbles[i].radius);
+        min_y = SDL_min(min_y, bubbles[i].position.y - bubbles[i].radius);
+        max_x = SDL_max(max_x, bubbles[i].position.x + bubbles[i].radius);
+        max_y = SDL_max(max_y, bubbles[i].position.y + bubbles[i].radius);
+    }
+
+    int columns;
+    int rows;
+    for(;;) {
+        columns = (int)SDL_ceilf((max_x - min_x) / cell_size) + 1;
+        rows = (int)SDL_ceilf((max_y - min_y) / cell_size) + 1;
+        if((Sint64)columns * rows <= WORLD_BUBBLE_GRID_MAX_CELLS) {
+            break;
         }
+        cell_size *= 2.f;
     }
-    return false;
+
+    int cell_count = columns * rows;
+    if(cell_count > grid->cell_capacity) {
+        grid->cells = SDL_realloc(grid->cells, (size_t)cell_count);
+        grid->starts = SDL_realloc(grid->starts, sizeof(int) * (size_t)(cell_count + 1));
+        grid->cell_capacity = cell_count;
+    }
+    grid->origin_x = min_x;
+    grid->origin_y = min_y;
+    grid->cell_size = cell_size;
+    grid->inv_cell_size = 1.f / cell_size;
+    grid->columns = columns;
+    grid->rows = rows;
+
+    //first pass: full cells and how many circles cross each cell
+    SDL_memset(grid->cells, WORLD_BUBBLE_CELL_Empty, (size_t)cell_count);
+    SDL_memset(grid->starts, 0, sizeof(int) * (size_t)(cell_count + 1));
+    for(int i = 0; i < bubble_count; i++) {
+        int x_from, y_from, x_to, y_to;
+        world__bubble_grid_span(grid, bubbles[i], &x_from, &y_from, &x_to, &y_to);
+        for(int y = y_from; y <= y_to; y++) {
+            for(int x = x_from; x <= x_to; x++) {
+                int cell = y * columns + x;
+                WorldBubbleCell relation = world__bubble_grid_classify(grid, bubbles[i], x, y);
+                if(relation == WORLD_BUBBLE_CELL_Full) {
+                    grid->cells[cell] = WORLD_BUBBLE_CELL_Full;
+                }
+                else if(relation == WORLD_BUBBLE_CELL_Boundary) {
+                    grid->starts[cell + 1]++;
+                }
+            }
+        }
+    }
+
+    //full cells keep no circles, the rest become boundary cells if anything crossed them
+    for(int i = 0; i < cell_count; i++) {
+        if(grid->cells[i] == WORLD_BUBBLE_CELL_Full) {
+            grid->starts[i + 1] = 0;
+        }
+        else if(grid->starts[i + 1] > 0) {
+            grid->cells[i] = WORLD_BUBBLE_CELL_Boundary;
+        }
+        grid->starts[i + 1] += grid->starts[i];
+    }
+
+    int circle_count = grid->starts[cell_count];
+    if(circle_count > grid->circle_capacity) {
+        grid->circle_x = SDL_realloc(grid->circle_x, sizeof(float) * (size_t)circle_count);
+        grid->circle_y = SDL_realloc(grid->circle_y, sizeof(float) * (size_t)circle_count);
+        grid->circle_radius = SDL_realloc(grid->circle_radius, sizeof(float) * (size_t)circle_count);
+        grid->circle_capacity = circle_count;
+    }
+
+    //second pass fills the lists, starts[i] is used as the write cursor and ends up at starts[i + 1]
+    for(int i = 0; i < bubble_count; i++) {
+        int x_from, y_from, x_to, y_to;
+        world__bubble_grid_span(grid, bubbles[i], &x_from, &y_from, &x_to, &y_to);
+        for(int y = y_from; y <= y_to; y++) {
+            for(int x = x_from; x <= x_to; x++) {
+                int cell = y * columns + x;
+                if(grid->cells[cell] == WORLD_BUBBLE_CELL_Boundary && world__bubble_grid_classify(grid, bubbles[i], x, y) == WORLD_BUBBLE_CELL_Boundary) {
+                    grid->circle_x[grid->starts[cell]] = bubbles[i].position.x;
+                    grid->circle_y[grid->starts[cell]] = bubbles[i].position.y;
+                    grid->circle_radius[grid->starts[cell]] = bubbles[i].radius;
+                    grid->starts[cell]++;
+                }
+            }
+        }
+    }
+    for(int i = cell_count; i > 0; i--) {
+        grid->starts[i] = grid->starts[i - 1];
+    }
+    grid->starts[0] = 0;
+}
+
+void world_bubble_grid_free(WorldBubbleGrid* grid) {
+    SDL_free(grid->cells);
+    SDL_free(grid->starts);
+    SDL_free(grid->circle_x);
+    SDL_free(grid->circle_y);
+    SDL_free(grid->circle_radius);
+    *grid = (WorldBubbleGrid) { 0 };
+}
+
+bool world_bubble_grid_contains(const WorldBubbleGrid* grid, HF_Vec2f point) {
+    float local_x = (point.x - grid->origin_x) * grid->inv_cell_size;
+    float local_y = (point.y - grid->origin_y) * grid->inv_cell_size;
+    if(!(local_x >= 0.f && local_y >= 0.f && local_x < (float)grid->columns && local_y < (float)grid->rows)) {
+        return false;
+    }
+
+    int cell = (int)local_y * grid->columns + (int)local_x;
+    switch(grid->cells[cell]) {
+    case WORLD_BUBBLE_CELL_Full:
+        return true;
+    case WORLD_BUBBLE_CELL_Boundary: {
+        int first = grid->starts[cell];
+        int count = grid->starts[cell + 1] - first;
+        return hf_batch_circles_contain(&grid->circle_x[first], &grid->circle_y[first], &grid->circle_radius[first], count, point) >= 0;
+    }
+    default:
+        return false;
+    }
+}
+
+bool world_point_is_in_bubble(World* world, HF_Vec2f point) {
+    return world_bubble_grid_contains(&world->bubble_grid, point);
 }
 
 bool world_point_is_off_world(World* world, HF_Vec2f point) {
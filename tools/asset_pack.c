@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pak_format.h"
+#include "tool_io.h"
+
+//asset_pack <output.pak> <assets folder> <file relative to the folder>...
+//writes the files into one archive that pak_open maps, see pak_format.h for the layout
+//a file given as name=path is read from path instead, for files generated by the build
+
+typedef struct PackFile_s {
+    const char* name;
+    unsigned char* data;
+    long size;
+} PackFile;
+
+static int pack_file_compare(const void* a, const void* b) {
+    return strcmp(((const PackFile*)a)->name, ((const PackFile*)b)->name);
+}
+
+int main(int argc, char* argv[]) {
+    if(argc < 4) {
+        fprintf(stderr, "usage: %s <output.pak> <assets folder> <files>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int file_count = argc - 3;
+    PackFile* files = calloc((size_t)file_count, sizeof(PackFile));
+    if(!files) {
+        return EXIT_FAILURE;
+    }
+
+    char path[1024];
+    for(int i = 0; i < file_count; i++) {
+        files[i].name = argv[i + 3];
+        char* source = strchr(argv[i + 3], '=');
+        if(source) {
+            *source++ = '\0';
+        }
+        if(strlen(files[i].name) >= PAK_NAME_SIZE) {
+            fprintf(stderr, "%s: name longer than %d characters\n", files[i].name, PAK_NAME_SIZE - 1);
+            return EXIT_FAILURE;
+        }
+
+        if(source) {
+            snprintf(path, sizeof(path), "%s", source);
+        }
+        else {
+            snprintf(path, sizeof(path), "%s/%s", argv[2], files[i].name);
+        }
+        files[i].data = tool_read_file(path, &files[i].size);
+        if(!files[i].data) {
+            fprintf(stderr, "%s: can't read\n", path);
+            return EXIT_FAILURE;
+        }
+    }
+    qsort(files, (size_t)file_count, sizeof(PackFile), pack_file_compare);
+
+    for(int i = 1; i < file_count; i++) {
+        if(strcmp(files[i - 1].name, files[i].name) == 0) {
+            fprintf(stderr, "%s: listed twice\n", files[i].name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE* out = fopen(argv[1], "wb");
+    if(!out) {
+        fprintf(stderr, "%s: can't write\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned char header[sizeof(PakHeader)] = { 0 };
+    tool_write_u32(&header[0], PAK_MAGIC);
+    tool_write_u32(&header[4], PAK_VERSION);
+    tool_write_u32(&header[8], (unsigned long)file_count);
+    fwrite(header, 1, sizeof(header), out);
+
+    unsigned long offset = (unsigned long)(sizeof(PakHeader) + sizeof(PakEntry) * (size_t)file_count);
+    for(int i = 0; i < file_count; i++) {
+        offset = (offset + PAK_ALIGNMENT - 1) & ~(unsigned long)(PAK_ALIGNMENT - 1);
+
+        unsigned char entry[sizeof(PakEntry)] = { 0 };
+        memcpy(entry, files[i].name, strlen(files[i].name));
+        tool_write_u32(&entry[PAK_NAME_SIZE], offset);
+        tool_write_u32(&entry[PAK_NAME_SIZE + 4], (unsigned long)files[i].size);
+        fwrite(entry, 1, sizeof(entry), out);
+
+        offset += (unsigned long)files[i].size;
+    }
+
+    static const unsigned char padding[PAK_ALIGNMENT] = { 0 };
+    for(int i = 0; i < file_count; i++) {
+        long position = ftell(out);
+        fwrite(padding, 1, (size_t)((PAK_ALIGNMENT - position % PAK_ALIGNMENT) % PAK_ALIGNMENT), out);
+        fwrite(files[i].data, 1, (size_t)files[i].size, out);
+        free(files[i].data);
+    }
+
+    if(fclose(out) != 0) {
+        fprintf(stderr, "%s: write failed\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    printf("%s: %d files, %lu bytes\n", argv[1], file_count, offset);
+    free(files);
+    return EXIT_SUCCESS;
+}
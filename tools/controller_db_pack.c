@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "controller_db_format.h"
+#include "tool_io.h"
+
+//controller_db_pack <output.bin> <gamecontrollerdb.txt>
+//bakes the text db into the table controller_db_load reads, see controller_db_format.h for the layout
+
+typedef struct PackMapping_s {
+    unsigned char guid[CONTROLLER_DB_GUID_SIZE];
+    unsigned long platform;
+    const char* line;//the line without its platform field
+    size_t length;
+    int order;//line number, a later line replaces an earlier one like in SDL
+} PackMapping;
+
+static int pack_mapping_compare(const void* a, const void* b) {
+    const PackMapping* left = a;
+    const PackMapping* right = b;
+    int order = memcmp(left->guid, right->guid, sizeof(left->guid));
+    if(order == 0) {
+        order = (left->platform > right->platform) - (left->platform < right->platform);
+    }
+    if(order == 0) {
+        order = (left->order > right->order) - (left->order < right->order);
+    }
+    return order;
+}
+
+static int hex_digit(char c) {
+    if(c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if(c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if(c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+//same bytes SDL_JoystickGetGUIDFromString gives, "xinput" is SDL's default for every XInput device and gets a zero guid
+static int parse_guid(const char* text, unsigned char* guid) {
+    if(strncmp(text, "xinput,", 7) == 0) {
+        memset(guid, 0, CONTROLLER_DB_GUID_SIZE);
+        return 1;
+    }
+    for(int i = 0; i < CONTROLLER_DB_GUID_SIZE; i++) {
+        int high = hex_digit(text[i * 2]);
+        int low = high < 0 ? -1 : hex_digit(text[i * 2 + 1]);
+        if(low < 0) {
+            return 0;
+        }
+        guid[i] = (unsigned char)(high << 4 | low);
+    }
+    return text[32] == ',';
+}
+
+//cuts "platform:name," out of line in place, returns the platform or -1 when it's unknown
+static int take_platform(char* line) {
+    static const char* const names[] = CONTROLLER_DB_PLATFORM_NAMES;
+    static const char field[] = "platform:";
+
+    char* start = strstr(line, field);
+    if(!start) {
+        return CONTROLLER_DB_PLATFORM_Any;
+    }
+    char* name = start + sizeof(field) - 1;
+    char* end = strchr(name, ',');
+    size_t name_length = end ? (size_t)(end - name) : strlen(name);
+
+    int platform = -1;
+    for(int i = 1; i < CONTROLLER_DB_PLATFORM_Count; i++) {
+        if(strlen(names[i]) == name_length && strncmp(names[i], name, name_length) == 0) {
+            platform = i;
+        }
+    }
+
+    char* rest = end ? end + 1 : name + name_length;
+    memmove(start, rest, strlen(rest) + 1);
+    return platform;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s <output.bin> <gamecontrollerdb.txt>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    long text_size;
+    char* text = (char*)tool_read_file(argv[2], &text_size);
+    if(!text) {
+        fprintf(stderr, "%s: can't read\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    int line_count = 1;
+    for(long i = 0; i < text_size; i++) {
+        line_count += text[i] == '\n';
+    }
+    PackMapping* mappings = calloc((size_t)line_count, sizeof(PackMapping));
+    if(!mappings) {
+        return EXIT_FAILURE;
+    }
+
+    int mapping_count = 0;
+    int line_number = 0;
+    for(char* line = text, * next; line < text + text_size; line = next) {
+        line_number++;
+        next = line + strcspn(line, "\n");
+        *next++ = '\0';
+        line[strcspn(line, "\r")] = '\0';
+        if(line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        PackMapping* mapping = &mappings[mapping_count];
+        if(!parse_guid(line, mapping->guid)) {
+            fprintf(stderr, "%s:%d: no guid, skipped\n", argv[2], line_number);
+            continue;
+        }
+        int platform = take_platform(line);
+        if(platform < 0) {
+            continue;//can't be used by any platform we ship on
+        }
+        mapping->platform = (unsigned long)platform;
+        mapping->line = line;
+        mapping->length = strlen(line);
+        mapping->order = line_number;
+        mapping_count++;
+    }
+    qsort(mappings, (size_t)mapping_count, sizeof(PackMapping), pack_mapping_compare);
+
+    //keep the last line of every guid and platform pair, they are sorted by line within a pair
+    int unique_count = 0;
+    for(int i = 0; i < mapping_count; i++) {
+        PackMapping* next = i + 1 < mapping_count ? &mappings[i + 1] : NULL;
+        if(next && memcmp(next->guid, mappings[i].guid, CONTROLLER_DB_GUID_SIZE) == 0 && next->platform == mappings[i].platform) {
+            continue;
+        }
+        mappings[unique_count++] = mappings[i];
+    }
+
+    FILE* out = fopen(argv[1], "wb");
+    if(!out) {
+        fprintf(stderr, "%s: can't write\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long strings_size = 0;
+    for(int i = 0; i < unique_count; i++) {
+        strings_size += (unsigned long)mappings[i].length + 1;
+    }
+
+    unsigned char header[sizeof(ControllerDbHeader)] = { 0 };
+    tool_write_u32(&header[0], CONTROLLER_DB_MAGIC);
+    tool_write_u32(&header[4], CONTROLLER_DB_VERSION);
+    tool_write_u32(&header[8], (unsigned long)unique_count);
+    tool_write_u32(&header[12], strings_size);
+    fwrite(header, 1, sizeof(header), out);
+
+    unsigned long offset = 0;
+    for(int i = 0; i < unique_count; i++) {
+        unsigned char entry[sizeof(ControllerDbEntry)] = { 0 };
+        memcpy(entry, mappings[i].guid, CONTROLLER_DB_GUID_SIZE);
+        tool_write_u32(&entry[CONTROLLER_DB_GUID_SIZE], mappings[i].platform);
+        tool_write_u32(&entry[CONTROLLER_DB_GUID_SIZE + 4], offset);
+        fwrite(entry, 1, sizeof(entry), out);
+        offset += (unsigned long)mappings[i].length + 1;
+    }
+    for(int i = 0; i < unique_count; i++) {
+        fwrite(mappings[i].line, 1, mappings[i].length + 1, out);
+    }
+
+    if(fclose(out) != 0) {
+        fprintf(stderr, "%s: write failed\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    printf("%s: %d mappings from %d lines, %lu bytes\n", argv[1], unique_count, line_number,
+           (unsigned long)(sizeof(ControllerDbHeader) + sizeof(ControllerDbEntry) * (size_t)unique_count) + strings_size);
+    free(mappings);
+    free(text);
+    return EXIT_SUCCESS;
+}
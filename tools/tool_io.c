@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tool_io.h"
+
+void tool_write_u32(unsigned char* out, unsigned long value) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+    out[2] = (unsigned char)((value >> 16) & 0xFF);
+    out[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+unsigned char* tool_read_file(const char* path, long* size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) {
+        return NULL;
+    }
+
+    unsigned char* data = NULL;
+    if(fseek(file, 0, SEEK_END) == 0 && (*size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)*size + 1);
+        if(data && fread(data, 1, (size_t)*size, file) != (size_t)*size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    if(data) {
+        data[*size] = '\0';
+    }
+    return data;
+}
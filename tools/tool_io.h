@@ -0,0 +1,11 @@
+#ifndef TOOL_IO_H
+#define TOOL_IO_H
+
+//file helpers shared by the offline packers, plain C, no SDL
+
+//little endian, whatever the host is
+void tool_write_u32(unsigned char* out, unsigned long value);
+//whole file plus a zero after it so text can be parsed in place, free it with free, NULL when it can't be read
+unsigned char* tool_read_file(const char* path, long* size);
+
+#endif//TOOL_IO_H